@@ -0,0 +1,644 @@
+/* dbf2parquet_bench: gera um DBF sintético (e as variantes .dbc comprimidas
+   com DCL) com a forma pedida e mede cada etapa da conversão isoladamente,
+   em linhas/s e MB/s, para comparar versões:
+
+     descompressão DCL   blast() do fluxo .dbc (literais codificados e crus)
+     flags de deletado   dbf_scan_deleted()
+     decodificação       dbf_decode_column() das colunas N/F/D/L
+     transcodificação    dbf_decode_column() das colunas C (recorte + UTF-8)
+     montagem Arrow      aw_decode_batch() (decodificação + arrays, todas as colunas)
+     escrita Parquet     aw_write_batch() dos batches já montados
+     total               conv_run() completo, como o dbf2parquet
+
+   MB/s é sobre os bytes de registro lidos pela etapa (só os campos das
+   colunas envolvidas na decodificação/transcodificação). Cada etapa roda
+   --repeat vezes e vale a mais rápida.
+
+   Uso:
+     dbf2parquet_bench [opções de forma] [--batch-size N] [--threads N]
+                       [--repeat N] [--compression CODEC] [--keep DIR]
+     dbf2parquet_bench --generate <arquivo.dbf|arquivo.dbc> [opções de forma]
+
+   Forma do arquivo:
+     --rows N               registros (default 1000000)
+     --mix C:4,N:3,F:2,D:2,L:1   colunas de cada tipo nativo
+     --char-width W         largura dos campos C (default 20)
+     --num-width W          largura dos campos N/F (default 10; F com 3 decimais)
+     --null-ratio R         fração de campos vazios (default 0.05)
+     --high-byte-ratio R    fração de textos com bytes >= 0x80 (acentos CP1252; default 0.1)
+     --deleted-ratio R      fração de registros deletados (default 0.01)
+     --seed S
+     --dbc-literals coded|raw, --dbc-dict 4|5|6   variante do .dbc (--generate) */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <getopt.h>
+#include <glib.h>
+#include <glib/gstdio.h>
+#include "dbf_reader.h"
+#include "encoding.h"
+#include "arrow_writer.h"
+#include "convert.h"
+#include "blast.h"
+#include "dcl_implode.h"
+
+enum { MIX_C, MIX_N, MIX_F, MIX_D, MIX_L, MIX_TYPES };
+static const char mix_types[] = "CNFDL";   /* na ordem de MIX_* */
+
+typedef struct {
+    int      rows;
+    int      mix[MIX_TYPES];
+    int      char_width;
+    int      num_width;
+    double   null_ratio;
+    double   high_ratio;
+    double   deleted_ratio;
+    uint64_t seed;
+} Shape;
+
+typedef struct {
+    Shape       shape;
+    const char *generate;      /* só gera o arquivo */
+    int         dbc_coded;
+    int         dbc_dict;
+    int         batch_size;
+    int         threads;
+    int         repeat;
+    const char *keep;          /* diretório dos arquivos gerados (não apagados) */
+    AwWriteOpts write;
+} BenchOpts;
+
+/* --- gerador --- */
+
+static uint64_t rnd(uint64_t *s) {
+    /* xorshift64*: rápido e reproduzível pela --seed */
+    *s ^= *s >> 12;
+    *s ^= *s << 25;
+    *s ^= *s >> 27;
+    return *s * 2685821657736338717ULL;
+}
+
+static double rnd01(uint64_t *s) {
+    return (double)(rnd(s) >> 11) / (double)(1ULL << 53);
+}
+
+static int field_width(const Shape *sh, int type) {
+    switch (type) {
+        case MIX_C: return sh->char_width;
+        case MIX_D: return 8;
+        case MIX_L: return 1;
+        default:    return sh->num_width;
+    }
+}
+
+/* Campo `type` de largura w em dst (sem terminador) */
+static void gen_value(const Shape *sh, int type, int w, uint64_t *s, unsigned char *dst) {
+    static const char text[] = "ABCDEFGHIJKLMNOPRSTUVZ0123456789    ";
+    static const unsigned char high[] = { 0xC7, 0xE7, 0xC3, 0xE3, 0xD5, 0xF5, 0xC9, 0xE9, 0xC1, 0xE1 };
+    char tmp[64];
+    memset(dst, ' ', (size_t)w);
+    if (rnd01(s) < sh->null_ratio) {
+        if (type == MIX_L) dst[0] = '?';
+        return;
+    }
+    switch (type) {
+        case MIX_C: {
+            int len = 1 + (int)(rnd(s) % (uint64_t)w);
+            for (int i = 0; i < len; i++) dst[i] = (unsigned char)text[rnd(s) % (sizeof(text) - 1)];
+            dst[0] = (unsigned char)text[rnd(s) % 22];
+            if (rnd01(s) < sh->high_ratio)
+                dst[rnd(s) % (uint64_t)len] = high[rnd(s) % sizeof(high)];
+            break;
+        }
+        case MIX_N: {
+            int digits = 1 + (int)(rnd(s) % (uint64_t)(w - 1 < 18 ? w - 1 : 18));
+            long long v = (long long)(rnd(s) % 1000000000000000000ULL);
+            for (int i = digits; i < 18; i++) v /= 10;
+            int n = snprintf(tmp, sizeof(tmp), "%lld", rnd01(s) < 0.1 ? -v : v);
+            if (n <= w) memcpy(dst + w - n, tmp, (size_t)n);
+            break;
+        }
+        case MIX_F: {
+            double max = 1.0;
+            for (int i = 0; i < w - 6 && i < 15; i++) max *= 10.0;
+            int n = snprintf(tmp, sizeof(tmp), "%.3f", (rnd01(s) - 0.2) * max);
+            if (n <= w) memcpy(dst + w - n, tmp, (size_t)n);
+            break;
+        }
+        case MIX_D: {
+            snprintf(tmp, sizeof(tmp), "%04d%02d%02d", 1990 + (int)(rnd(s) % 35),
+                     1 + (int)(rnd(s) % 12), 1 + (int)(rnd(s) % 28));
+            memcpy(dst, tmp, 8);
+            break;
+        }
+        default:
+            dst[0] = (unsigned char)("TFtfYN"[rnd(s) % 6]);
+            break;
+    }
+}
+
+/* Imagem completa do .dbf (cabeçalho, registros e 0x1A) em memória */
+static unsigned char* gen_dbf(const Shape *sh, size_t *len, size_t *header_len) {
+    int nfields = 0, record_len = 1;
+    for (int t = 0; t < MIX_TYPES; t++) {
+        nfields += sh->mix[t];
+        record_len += sh->mix[t] * field_width(sh, t);
+    }
+    size_t hl = 32 + 32 * (size_t)nfields + 1;
+    size_t total = hl + (size_t)sh->rows * (size_t)record_len + 1;
+    unsigned char *img = (unsigned char*)calloc(1, total);
+    if (!img) return NULL;
+
+    img[0] = 0x03;
+    img[1] = 124; img[2] = 1; img[3] = 1;          /* 2024-01-01 */
+    for (int i = 0; i < 4; i++) img[4 + i] = (unsigned char)((uint32_t)sh->rows >> (8 * i));
+    img[8]  = (unsigned char)(hl & 0xff);
+    img[9]  = (unsigned char)(hl >> 8);
+    img[10] = (unsigned char)(record_len & 0xff);
+    img[11] = (unsigned char)(record_len >> 8);
+    img[29] = 0x57;                                 /* LDID: CP1252 */
+
+    unsigned char *d = img + 32;
+    for (int t = 0; t < MIX_TYPES; t++) {
+        for (int k = 0; k < sh->mix[t]; k++, d += 32) {
+            snprintf((char*)d, 11, "%c%d", mix_types[t], k + 1);
+            d[11] = (unsigned char)mix_types[t];
+            d[16] = (unsigned char)field_width(sh, t);
+            d[17] = t == MIX_F ? 3 : 0;
+        }
+    }
+    *d = 0x0D;
+
+    uint64_t s = sh->seed ? sh->seed : 1;
+    unsigned char *rec = img + hl;
+    for (int r = 0; r < sh->rows; r++) {
+        rec[0] = rnd01(&s) < sh->deleted_ratio ? '*' : ' ';
+        unsigned char *p = rec + 1;
+        for (int t = 0; t < MIX_TYPES; t++) {
+            int w = field_width(sh, t);
+            for (int k = 0; k < sh->mix[t]; k++, p += w) gen_value(sh, t, w, &s, p);
+        }
+        rec += record_len;
+    }
+    *rec = 0x1A;
+
+    *len = total;
+    *header_len = hl;
+    return img;
+}
+
+static int write_file(const char *path, const unsigned char *a, size_t alen,
+                      const unsigned char *b, size_t blen) {
+    FILE *f = fopen(path, "wb");
+    if (!f) { fprintf(stderr, "Erro criando %s\n", path); return -1; }
+    int ok = fwrite(a, 1, alen, f) == alen && (!blen || fwrite(b, 1, blen, f) == blen);
+    if (fclose(f) != 0) ok = 0;
+    if (!ok) fprintf(stderr, "Erro gravando %s\n", path);
+    return ok ? 0 : -1;
+}
+
+/* .dbc: cabeçalho DBF sem compressão, 4 bytes (CRC, não verificado) e o fluxo DCL */
+static int write_dbc(const char *path, const unsigned char *img, size_t len, size_t hl,
+                     int coded, int dict_bits) {
+    unsigned char *z = NULL;
+    size_t zlen = 0;
+    if (dcl_implode(img + hl, len - hl, coded, dict_bits, &z, &zlen) != 0) {
+        fprintf(stderr, "Erro comprimindo %s\n", path);
+        return -1;
+    }
+    unsigned char *head = (unsigned char*)malloc(hl + 4);
+    int rc = -1;
+    if (head) {
+        memcpy(head, img, hl);
+        memset(head + hl, 0, 4);
+        rc = write_file(path, head, hl + 4, z, zlen);
+    }
+    free(head);
+    free(z);
+    return rc;
+}
+
+/* --- medição --- */
+
+typedef struct {
+    const char *name;
+    double      best;      /* s */
+    long long   rows;
+    long long   bytes;
+} Stage;
+
+static double now_s(void) {
+    return (double)g_get_monotonic_time() / 1e6;
+}
+
+static void stage_report(const Stage *st) {
+    double s = st->best > 0 ? st->best : 1e-9;
+    int pad = 44 - (int)g_utf8_strlen(st->name, -1);   /* alinhado por caracteres, não bytes */
+    printf("%s%*s %9.3f %14.0f %10.1f\n", st->name, pad > 0 ? pad : 0, "", st->best,
+           (double)st->rows / s, (double)st->bytes / s / (1024.0 * 1024.0));
+}
+
+/* Fluxo DCL de um .dbc inteiro em memória para o blast() */
+typedef struct {
+    unsigned char *buf;
+    size_t         len;
+    size_t         pos;
+    long long      out;
+} DclMem;
+
+static unsigned dcl_in(void *how, unsigned char **buf) {
+    DclMem *m = (DclMem*)how;
+    size_t k = m->len - m->pos < 65536 ? m->len - m->pos : 65536;
+    *buf = m->buf + m->pos;
+    m->pos += k;
+    return (unsigned)k;
+}
+
+static int dcl_out(void *how, unsigned char *buf, unsigned len) {
+    (void)buf;
+    ((DclMem*)how)->out += len;
+    return 0;
+}
+
+static int bench_decompress(const char *path, size_t hl, const BenchOpts *bo, Stage *st) {
+    DclMem m;
+    memset(&m, 0, sizeof(m));
+    gsize len = 0;
+    if (!g_file_get_contents(path, (gchar**)&m.buf, &len, NULL) || len < hl + 4) {
+        fprintf(stderr, "Erro lendo %s\n", path);
+        g_free(m.buf);
+        return -1;
+    }
+    for (int it = 0; it < bo->repeat; it++) {
+        m.pos = hl + 4;
+        m.len = len;
+        m.out = 0;
+        double t0 = now_s();
+        int rc = blast(dcl_in, &m, dcl_out, &m);
+        double dt = now_s() - t0;
+        if (rc != 0) {
+            fprintf(stderr, "%s: blast error %d\n", path, rc);
+            g_free(m.buf);
+            return -1;
+        }
+        if (it == 0 || dt < st->best) st->best = dt;
+    }
+    st->rows = bo->shape.rows;
+    st->bytes = m.out;
+    g_free(m.buf);
+    return 0;
+}
+
+static int bench_deleted(const DbfCtx *ctx, const BenchOpts *bo, Stage *st) {
+    int *sel = (int*)malloc((size_t)bo->batch_size * sizeof(int));
+    if (!sel) return -1;
+    long long ndel = 0;
+    for (int it = 0; it < bo->repeat; it++) {
+        ndel = 0;
+        double t0 = now_s();
+        for (int row = 0; row < ctx->nrecords; row += bo->batch_size) {
+            int n = ctx->nrecords - row < bo->batch_size ? ctx->nrecords - row : bo->batch_size;
+            int k = dbf_scan_deleted(ctx, row, n, sel);
+            if (k < 0) { free(sel); return -1; }
+            ndel += k;
+        }
+        double dt = now_s() - t0;
+        if (it == 0 || dt < st->best) st->best = dt;
+    }
+    free(sel);
+    st->rows = ctx->nrecords;
+    st->bytes = (long long)ctx->nrecords * ctx->record_len;
+    return 0;
+}
+
+/* Colunas de texto (text = 1) ou as demais, lote a lote, sem seleção */
+static int bench_columns(const DbfCtx *ctx, const ColumnSpec *cols, int ncols, int text,
+                         const BenchOpts *bo, Stage *st) {
+    EncCtx enc;
+    if (enc_open(&enc, "CP1252") != 0) return -1;
+    long long width = 0;
+    for (int c = 0; c < ncols; c++)
+        if ((cols[c].kind == COL_UTF8) == text) width += cols[c].width;
+
+    for (int it = 0; it < bo->repeat; it++) {
+        double t0 = now_s();
+        for (int row = 0; row < ctx->nrecords; row += bo->batch_size) {
+            int n = ctx->nrecords - row < bo->batch_size ? ctx->nrecords - row : bo->batch_size;
+            for (int c = 0; c < ncols; c++) {
+                if ((cols[c].kind == COL_UTF8) != text) continue;
+                ColBuf cb;
+                int err_row;
+                if (dbf_decode_column(ctx, &cols[c], row, NULL, n, &enc, 0, &cb, &err_row) != 0) {
+                    enc_close(&enc);
+                    return -1;
+                }
+                colbuf_free(&cb);
+            }
+        }
+        double dt = now_s() - t0;
+        if (it == 0 || dt < st->best) st->best = dt;
+    }
+    enc_close(&enc);
+    st->rows = ctx->nrecords;
+    st->bytes = (long long)ctx->nrecords * width;
+    return 0;
+}
+
+/* Monta os RecordBatches (um por lote, deletados pulados); os da última
+   repetição ficam em `batches` para a etapa de escrita */
+static int bench_arrow(const DbfCtx *ctx, const ColumnSpec *cols, int ncols, GArrowSchema *schema,
+                       const BenchOpts *bo, GPtrArray *batches, Stage *st) {
+    EncCtx enc;
+    if (enc_open(&enc, "CP1252") != 0) return -1;
+    int *sel = (int*)malloc((size_t)bo->batch_size * sizeof(int));
+    if (!sel) { enc_close(&enc); return -1; }
+
+    int rc = 0;
+    for (int it = 0; rc == 0 && it < bo->repeat; it++) {
+        g_ptr_array_set_size(batches, 0);
+        double t0 = now_s();
+        for (int row = 0; rc == 0 && row < ctx->nrecords; row += bo->batch_size) {
+            int n = ctx->nrecords - row < bo->batch_size ? ctx->nrecords - row : bo->batch_size;
+            int ndel = dbf_scan_deleted(ctx, row, n, sel);
+            GArrowRecordBatch *batch = NULL;
+            int err_row;
+            if (ndel < 0 || aw_decode_batch(schema, cols, ncols, ctx, row, ndel ? sel : NULL, n - ndel,
+                                            &enc, 0, &batch, &err_row) != 0)
+                rc = -1;
+            else
+                g_ptr_array_add(batches, batch);
+        }
+        double dt = now_s() - t0;
+        if (it == 0 || dt < st->best) st->best = dt;
+    }
+    free(sel);
+    enc_close(&enc);
+    st->rows = ctx->nrecords;
+    st->bytes = (long long)ctx->nrecords * ctx->record_len;
+    return rc;
+}
+
+static int bench_parquet(const char *path, GArrowSchema *schema, GPtrArray *batches,
+                         const DbfCtx *ctx, const BenchOpts *bo, Stage *st, long long *out_bytes) {
+    for (int it = 0; it < bo->repeat; it++) {
+        double t0 = now_s();
+        GParquetArrowFileWriter *w = aw_open_parquet(path, schema, &bo->write);
+        if (!w) return -1;
+        for (guint i = 0; i < batches->len; i++) {
+            if (aw_write_batch(w, (GArrowRecordBatch*)g_ptr_array_index(batches, i)) != 0) {
+                g_object_unref(w);
+                return -1;
+            }
+        }
+        if (aw_close_parquet(w) != 0) return -1;
+        double dt = now_s() - t0;
+        if (it == 0 || dt < st->best) st->best = dt;
+    }
+    GStatBuf sb;
+    *out_bytes = g_stat(path, &sb) == 0 ? (long long)sb.st_size : 0;
+    st->rows = ctx->nrecords;
+    st->bytes = (long long)ctx->nrecords * ctx->record_len;
+    return 0;
+}
+
+static int write_to_parquet(void *user, GArrowRecordBatch *batch) {
+    return aw_write_batch((GParquetArrowFileWriter*)user, batch);
+}
+
+static int bench_total(const char *path, DbfCtx *ctx, const ColumnSpec *cols, int ncols,
+                       GArrowSchema *schema, const BenchOpts *bo, Stage *st) {
+    ConvOpts opts;
+    memset(&opts, 0, sizeof(opts));
+    opts.batch_size = bo->batch_size;
+    opts.threads = bo->threads;
+    for (int it = 0; it < bo->repeat; it++) {
+        double t0 = now_s();
+        GParquetArrowFileWriter *w = aw_open_parquet(path, schema, &bo->write);
+        if (!w) return -1;
+        ConvSink sink = { write_to_parquet, w, NULL };
+        int err_row;
+        if (conv_run(ctx, cols, ncols, schema, "CP1252", &sink, &opts, &err_row) != CONV_OK) {
+            g_object_unref(w);
+            return -1;
+        }
+        if (aw_close_parquet(w) != 0) return -1;
+        double dt = now_s() - t0;
+        if (it == 0 || dt < st->best) st->best = dt;
+    }
+    st->rows = ctx->nrecords;
+    st->bytes = (long long)ctx->nrecords * ctx->record_len;
+    return 0;
+}
+
+static int run_bench(const BenchOpts *bo) {
+    const Shape *sh = &bo->shape;
+    char *dir = NULL;
+    if (bo->keep) {
+        if (g_mkdir_with_parents(bo->keep, 0755) != 0) {
+            fprintf(stderr, "Erro criando %s\n", bo->keep);
+            return 2;
+        }
+        dir = g_strdup(bo->keep);
+    } else if (!(dir = g_dir_make_tmp("dbf2parquet-bench-XXXXXX", NULL))) {
+        fprintf(stderr, "Erro criando diretório temporário\n");
+        return 2;
+    }
+    char *dbf  = g_build_filename(dir, "bench.dbf", NULL);
+    char *dbc1 = g_build_filename(dir, "bench-coded.dbc", NULL);
+    char *dbc0 = g_build_filename(dir, "bench-raw.dbc", NULL);
+    char *pq   = g_build_filename(dir, "bench.parquet", NULL);
+    char *pqt  = g_build_filename(dir, "total.parquet", NULL);
+
+    double t0 = now_s();
+    size_t len = 0, hl = 0;
+    unsigned char *img = gen_dbf(sh, &len, &hl);
+    int rc = img ? 0 : 2;
+    if (rc == 0 && (write_file(dbf, img, len, NULL, 0) != 0 ||
+                    write_dbc(dbc1, img, len, hl, 1, bo->dbc_dict) != 0 ||
+                    write_dbc(dbc0, img, len, hl, 0, bo->dbc_dict) != 0))
+        rc = 2;
+    free(img);
+    if (rc == 0)
+        fprintf(stderr, "Gerados %d registros em %s (%.1f s)\n", sh->rows, dir, now_s() - t0);
+
+    DbfCtx ctx;
+    ColumnSpec *cols = NULL;
+    if (rc == 0 && dbf_open(dbf, &ctx, &cols) != 0) rc = 4;
+
+    if (rc == 0) {
+        int ncols = ctx.nfields;
+        dbf_narrow_ints(cols, ncols);   /* como o default --infer width */
+        GArrowSchema *schema = aw_build_schema(cols, ncols);
+        GPtrArray *batches = g_ptr_array_new_with_free_func(g_object_unref);
+        long long pq_bytes = 0;
+
+        Stage st[] = {
+            { "descompressão DCL (literais codificados)", 0, 0, 0 },
+            { "descompressão DCL (literais crus)",        0, 0, 0 },
+            { "flags de deletado (dbf_scan_deleted)",     0, 0, 0 },
+            { "decodificação N/F/D/L (dbf_decode_column)", 0, 0, 0 },
+            { "transcodificação C (dbf_decode_column)",   0, 0, 0 },
+            { "montagem Arrow (aw_decode_batch)",         0, 0, 0 },
+            { "escrita Parquet (aw_write_batch)",         0, 0, 0 },
+            { "total (conv_run)",                         0, 0, 0 },
+        };
+        if (bench_decompress(dbc1, hl, bo, &st[0]) != 0 ||
+            bench_decompress(dbc0, hl, bo, &st[1]) != 0 ||
+            bench_deleted(&ctx, bo, &st[2]) != 0 ||
+            bench_columns(&ctx, cols, ncols, 0, bo, &st[3]) != 0 ||
+            bench_columns(&ctx, cols, ncols, 1, bo, &st[4]) != 0 ||
+            bench_arrow(&ctx, cols, ncols, schema, bo, batches, &st[5]) != 0 ||
+            bench_parquet(pq, schema, batches, &ctx, bo, &st[6], &pq_bytes) != 0 ||
+            bench_total(pqt, &ctx, cols, ncols, schema, bo, &st[7]) != 0) {
+            fprintf(stderr, "Falha medindo as etapas.\n");
+            rc = 7;
+        } else {
+            printf("%d registros x %ld bytes (%.1f MB), colunas C:%d N:%d F:%d D:%d L:%d, "
+                   "nulos %.0f%%, acentos %.0f%%, deletados %.0f%%, lote %d, threads %d\n",
+                   ctx.nrecords, ctx.record_len,
+                   (double)ctx.nrecords * ctx.record_len / (1024.0 * 1024.0),
+                   sh->mix[MIX_C], sh->mix[MIX_N], sh->mix[MIX_F], sh->mix[MIX_D], sh->mix[MIX_L],
+                   sh->null_ratio * 100, sh->high_ratio * 100, sh->deleted_ratio * 100,
+                   bo->batch_size, bo->threads);
+            printf("%-44s %9s %14s %10s\n", "etapa", "s", "linhas/s", "MB/s");
+            for (size_t i = 0; i < sizeof(st) / sizeof(st[0]); i++) stage_report(&st[i]);
+            printf("Parquet: %.1f MB\n", (double)pq_bytes / (1024.0 * 1024.0));
+        }
+        g_ptr_array_free(batches, TRUE);
+        g_object_unref(schema);
+        dbf_close(&ctx);
+        free(cols);
+    }
+
+    if (!bo->keep) {
+        const char *files[] = { dbf, dbc1, dbc0, pq, pqt };
+        for (size_t i = 0; i < sizeof(files) / sizeof(files[0]); i++) g_remove(files[i]);
+        g_rmdir(dir);
+    }
+    g_free(dbf); g_free(dbc1); g_free(dbc0); g_free(pq); g_free(pqt);
+    g_free(dir);
+    return rc;
+}
+
+/* --- linha de comando --- */
+
+static int parse_mix(const char *s, int mix[MIX_TYPES]) {
+    memset(mix, 0, sizeof(int) * MIX_TYPES);
+    char **items = g_strsplit(s, ",", -1);
+    int rc = 0, total = 0;
+    for (int i = 0; rc == 0 && items[i]; i++) {
+        const char *p = strchr(mix_types, g_ascii_toupper(items[i][0]));
+        char *end = NULL;
+        long n = items[i][0] && items[i][1] == ':' ? strtol(items[i] + 2, &end, 10) : -1;
+        if (!p || !*p || n < 0 || n > 200 || !end || *end) rc = -1;
+        else total += mix[p - mix_types] = (int)n;
+    }
+    g_strfreev(items);
+    return rc == 0 && total > 0 ? 0 : -1;
+}
+
+static int parse_ratio(const char *s, double *out) {
+    char *end = NULL;
+    double v = g_ascii_strtod(s, &end);
+    if (end == s || *end || v < 0 || v > 1) return -1;
+    *out = v;
+    return 0;
+}
+
+static int parse_cli(int argc, char **argv, BenchOpts *bo) {
+    static struct option long_opts[] = {
+        {"rows", required_argument, 0, 0},
+        {"mix", required_argument, 0, 0},
+        {"char-width", required_argument, 0, 0},
+        {"num-width", required_argument, 0, 0},
+        {"null-ratio", required_argument, 0, 0},
+        {"high-byte-ratio", required_argument, 0, 0},
+        {"deleted-ratio", required_argument, 0, 0},
+        {"seed", required_argument, 0, 0},
+        {"generate", required_argument, 0, 0},
+        {"dbc-literals", required_argument, 0, 0},
+        {"dbc-dict", required_argument, 0, 0},
+        {"batch-size", required_argument, 0, 0},
+        {"threads", required_argument, 0, 0},
+        {"repeat", required_argument, 0, 0},
+        {"compression", required_argument, 0, 0},
+        {"keep", required_argument, 0, 0},
+        {"help", no_argument, 0, 'h'},
+        {0,0,0,0}
+    };
+    memset(bo, 0, sizeof(*bo));
+    bo->shape.rows = 1000000;
+    parse_mix("C:4,N:3,F:2,D:2,L:1", bo->shape.mix);
+    bo->shape.char_width = 20;
+    bo->shape.num_width = 10;
+    bo->shape.null_ratio = 0.05;
+    bo->shape.high_ratio = 0.1;
+    bo->shape.deleted_ratio = 0.01;
+    bo->shape.seed = 42;
+    bo->dbc_coded = 1;
+    bo->dbc_dict = 6;
+    bo->batch_size = 100000;
+    bo->threads = 1;
+    bo->repeat = 3;
+    aw_write_opts_init(&bo->write);
+
+    int opt, idx;
+    while ((opt = getopt_long(argc, argv, "h", long_opts, &idx)) != -1) {
+        if (opt == 'h') {
+            printf("Uso: dbf2parquet_bench [--rows N] [--mix C:4,N:3,F:2,D:2,L:1] [--char-width W]\n"
+                   "         [--num-width W] [--null-ratio R] [--high-byte-ratio R] [--deleted-ratio R]\n"
+                   "         [--seed S] [--batch-size N] [--threads N] [--repeat N]\n"
+                   "         [--compression CODEC] [--keep DIR]\n"
+                   "       dbf2parquet_bench --generate <arquivo.dbf|.dbc> [forma]\n"
+                   "         [--dbc-literals coded|raw] [--dbc-dict 4|5|6]\n");
+            exit(0);
+        }
+        if (opt != 0) return -1;
+        const char *name = long_opts[idx].name;
+        int bad = 0;
+        if (strcmp(name, "rows")==0) bad = (bo->shape.rows = atoi(optarg)) <= 0;
+        else if (strcmp(name, "mix")==0) bad = parse_mix(optarg, bo->shape.mix) != 0;
+        else if (strcmp(name, "char-width")==0) bad = (bo->shape.char_width = atoi(optarg)) < 1 || bo->shape.char_width > 254;
+        else if (strcmp(name, "num-width")==0) bad = (bo->shape.num_width = atoi(optarg)) < 7 || bo->shape.num_width > 20;
+        else if (strcmp(name, "null-ratio")==0) bad = parse_ratio(optarg, &bo->shape.null_ratio) != 0;
+        else if (strcmp(name, "high-byte-ratio")==0) bad = parse_ratio(optarg, &bo->shape.high_ratio) != 0;
+        else if (strcmp(name, "deleted-ratio")==0) bad = parse_ratio(optarg, &bo->shape.deleted_ratio) != 0;
+        else if (strcmp(name, "seed")==0) bo->shape.seed = g_ascii_strtoull(optarg, NULL, 10);
+        else if (strcmp(name, "generate")==0) bo->generate = optarg;
+        else if (strcmp(name, "dbc-literals")==0) {
+            if (strcmp(optarg, "coded")==0) bo->dbc_coded = 1;
+            else if (strcmp(optarg, "raw")==0) bo->dbc_coded = 0;
+            else bad = 1;
+        }
+        else if (strcmp(name, "dbc-dict")==0) bad = (bo->dbc_dict = atoi(optarg)) < 4 || bo->dbc_dict > 6;
+        else if (strcmp(name, "batch-size")==0) bad = (bo->batch_size = atoi(optarg)) <= 0;
+        else if (strcmp(name, "threads")==0) bad = (bo->threads = atoi(optarg)) < 1;
+        else if (strcmp(name, "repeat")==0) bad = (bo->repeat = atoi(optarg)) < 1;
+        else if (strcmp(name, "compression")==0) bad = aw_parse_compression(optarg, &bo->write.compression) != 0;
+        else if (strcmp(name, "keep")==0) bo->keep = optarg;
+        if (bad) {
+            fprintf(stderr, "Valor inválido para --%s: %s\n", name, optarg);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    BenchOpts bo;
+    if (parse_cli(argc, argv, &bo) != 0) return 2;
+
+    if (!bo.generate) return run_bench(&bo);
+
+    size_t len = 0, hl = 0;
+    unsigned char *img = gen_dbf(&bo.shape, &len, &hl);
+    if (!img) return 2;
+    size_t n = strlen(bo.generate);
+    int rc = n > 4 && g_ascii_strcasecmp(bo.generate + n - 4, ".dbc") == 0
+           ? write_dbc(bo.generate, img, len, hl, bo.dbc_coded, bo.dbc_dict)
+           : write_file(bo.generate, img, len, NULL, 0);
+    free(img);
+    return rc == 0 ? 0 : 7;
+}
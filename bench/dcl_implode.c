@@ -0,0 +1,174 @@
+#include "dcl_implode.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAXBITS  13
+#define MINMATCH 3
+#define MAXMATCH 518            /* 519 = fim do fluxo */
+#define HASHBITS 15
+#define MAXCHAIN 16
+
+/* Comprimentos dos códigos fixos do formato, na forma compacta do blast.c:
+   (repetições - 1) << 4 | comprimento */
+static const unsigned char litlen[] = {
+    11, 124, 8, 7, 28, 7, 188, 13, 76, 4, 10, 8, 12, 10, 12, 10, 8, 23, 8,
+    9, 7, 6, 7, 8, 7, 6, 55, 8, 23, 24, 12, 11, 7, 9, 11, 12, 6, 7, 22, 5,
+    7, 24, 6, 11, 9, 6, 7, 22, 7, 11, 38, 7, 9, 8, 25, 11, 8, 11, 9, 12,
+    8, 12, 5, 38, 5, 38, 5, 11, 7, 5, 6, 21, 6, 10, 53, 8, 7, 24, 10, 27,
+    44, 253, 253, 253, 252, 252, 252, 13, 12, 45, 12, 45, 12, 61, 12, 45,
+    44, 173};
+static const unsigned char lenlen[] = {2, 35, 36, 53, 38, 23};
+static const unsigned char distlen[] = {2, 20, 53, 230, 247, 151, 248};
+
+static const short base[16] = {3, 2, 4, 5, 6, 7, 8, 9, 10, 12, 16, 24, 40, 72, 136, 264};
+static const char extra[16] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 3, 4, 5, 6, 7, 8};
+
+/* Código de um símbolo já no formato de saída: bits invertidos e em ordem
+   de envio (o blast lê o código do bit mais significativo, complementado) */
+typedef struct {
+    uint16_t bits;
+    uint8_t  len;
+} HuffCode;
+
+/* Códigos canônicos a partir dos comprimentos (mesma ordem do construct() do blast.c) */
+static void build_codes(const unsigned char *rep, int nrep, HuffCode *codes) {
+    int length[256];
+    int n = 0;
+    for (int i = 0; i < nrep; i++)
+        for (int k = (rep[i] >> 4) + 1; k > 0; k--) length[n++] = rep[i] & 15;
+
+    int count[MAXBITS + 1] = {0};
+    for (int s = 0; s < n; s++) count[length[s]]++;
+    int next[MAXBITS + 1];
+    int code = 0;
+    for (int len = 1; len <= MAXBITS; len++) {
+        next[len] = code;
+        code = (code + count[len]) << 1;
+    }
+    for (int s = 0; s < n; s++) {
+        int len = length[s];
+        int c = next[len]++;
+        uint16_t out = 0;
+        for (int i = 0; i < len; i++)            /* MSB primeiro, complementado */
+            out |= (uint16_t)((((c >> (len - 1 - i)) & 1) ^ 1) << i);
+        codes[s].bits = out;
+        codes[s].len = (uint8_t)len;
+    }
+}
+
+typedef struct {
+    unsigned char *buf;
+    size_t         len, cap;
+    uint32_t       acc;
+    int            nbits;
+    int            err;
+} BitOut;
+
+/* `n` <= 16 bits de `v`, LSB primeiro */
+static void put_bits(BitOut *o, uint32_t v, int n) {
+    o->acc |= v << o->nbits;
+    o->nbits += n;
+    while (o->nbits >= 8) {
+        if (o->len == o->cap) {
+            size_t cap = o->cap ? o->cap * 2 : 4096;
+            unsigned char *p = (unsigned char*)realloc(o->buf, cap);
+            if (!p) { o->err = 1; o->len = 0; }
+            else { o->buf = p; o->cap = cap; }
+        }
+        if (!o->err) o->buf[o->len++] = (unsigned char)o->acc;
+        o->acc >>= 8;
+        o->nbits -= 8;
+    }
+}
+
+static void put_code(BitOut *o, const HuffCode *c) {
+    put_bits(o, c->bits, c->len);
+}
+
+static void put_length(BitOut *o, const HuffCode *lencode, int len) {
+    int s = 15;
+    while (base[s] > len || len - base[s] >= (1 << extra[s])) s--;
+    put_code(o, &lencode[s]);
+    if (extra[s]) put_bits(o, (uint32_t)(len - base[s]), extra[s]);
+}
+
+static uint32_t hash3(const unsigned char *p) {
+    return ((uint32_t)p[0] << 16 | (uint32_t)p[1] << 8 | p[2]) * 2654435761u >> (32 - HASHBITS);
+}
+
+int dcl_implode(const unsigned char *in, size_t n, int coded, int dict_bits,
+                unsigned char **out, size_t *outlen) {
+    if (dict_bits < 4 || dict_bits > 6 || (coded != 0 && coded != 1)) return -1;
+
+    HuffCode litcode[256], lencode[16], distcode[64];
+    build_codes(litlen, (int)sizeof(litlen), litcode);
+    build_codes(lenlen, (int)sizeof(lenlen), lencode);
+    build_codes(distlen, (int)sizeof(distlen), distcode);
+
+    const size_t window = (size_t)64 << dict_bits;
+    int32_t *head = (int32_t*)malloc(sizeof(int32_t) << HASHBITS);
+    int32_t *prev = (int32_t*)malloc(sizeof(int32_t) * window);
+    if (!head || !prev) { free(head); free(prev); return -1; }
+    memset(head, 0xff, sizeof(int32_t) << HASHBITS);   /* -1 = vazio */
+
+    BitOut o;
+    memset(&o, 0, sizeof(o));
+    put_bits(&o, (uint32_t)coded, 8);
+    put_bits(&o, (uint32_t)dict_bits, 8);
+
+    size_t i = 0;
+    while (i < n && !o.err) {
+        size_t best = 0, dist = 0;
+        if (i + MINMATCH <= n) {
+            uint32_t h = hash3(in + i);
+            int32_t j = head[h];
+            for (int chain = 0; j >= 0 && chain < MAXCHAIN; chain++) {
+                size_t d = i - (size_t)j;
+                if (d > window) break;
+                size_t l = 0, max = n - i < MAXMATCH ? n - i : MAXMATCH;
+                while (l < max && in[(size_t)j + l] == in[i + l]) l++;
+                if (l > best) { best = l; dist = d; }
+                if (best == max) break;
+                int32_t pj = prev[(size_t)j % window];
+                if (pj >= j) break;                  /* elo sobrescrito pela janela */
+                j = pj;
+            }
+        }
+
+        size_t step = best >= MINMATCH ? best : 1;
+        if (best >= MINMATCH) {
+            put_bits(&o, 1, 1);
+            put_length(&o, lencode, (int)best);
+            size_t dd = dist - 1;
+            put_code(&o, &distcode[dd >> dict_bits]);
+            put_bits(&o, (uint32_t)(dd & ((1u << dict_bits) - 1)), dict_bits);
+        } else {
+            put_bits(&o, 0, 1);
+            if (coded) put_code(&o, &litcode[in[i]]);
+            else       put_bits(&o, in[i], 8);
+        }
+        /* todas as posições cobertas entram na cadeia */
+        for (size_t k = i; k < i + step; k++) {
+            if (k + MINMATCH > n) break;
+            uint32_t h = hash3(in + k);
+            prev[k % window] = head[h];
+            head[h] = (int32_t)k;
+        }
+        i += step;
+    }
+
+    /* fim do fluxo: cópia de comprimento 519 */
+    put_bits(&o, 1, 1);
+    put_code(&o, &lencode[15]);
+    put_bits(&o, 255, 8);
+    if (o.nbits) put_bits(&o, 0, 8 - o.nbits);
+
+    free(head);
+    free(prev);
+    if (o.err) { free(o.buf); return -1; }
+    *out = o.buf;
+    *outlen = o.len;
+    return 0;
+}
@@ -0,0 +1,18 @@
+#ifndef DCL_IMPLODE_H
+#define DCL_IMPLODE_H
+
+#include <stddef.h>
+
+/* Compressor PKWare DCL (o formato que blast() descomprime), só para gerar
+   .dbc sintéticos no benchmark: LZ77 guloso com cadeia de hash curta e as
+   tabelas Huffman fixas do formato. Não busca a melhor taxa, só um fluxo
+   válido com a mesma mistura de literais e cópias de um .dbc real.
+
+   `coded` = 1: literais pelo código Huffman (como os .dbc do DATASUS);
+   0: literais crus de 8 bits. `dict_bits` 4, 5 ou 6 (janela de 1, 2 ou 4 KiB).
+   Retorna 0 ok (*out com malloc, *outlen bytes), -1 parâmetro inválido ou
+   sem memória. */
+int dcl_implode(const unsigned char *in, size_t n, int coded, int dict_bits,
+                unsigned char **out, size_t *outlen);
+
+#endif
@@ -1,17 +1,37 @@
 #include "arrow_writer.h"
 #include <stdlib.h>
 #include <stddef.h>
+#include <string.h>
+
+/* dictionary<int32, utf8> */
+static GArrowDataType* dict_type(void) {
+    GArrowDataType *index = (GArrowDataType*)garrow_int32_data_type_new();
+    GArrowDataType *value = (GArrowDataType*)garrow_string_data_type_new();
+    GArrowDataType *dt = (GArrowDataType*)garrow_dictionary_data_type_new(index, value, FALSE);
+    g_object_unref(value);
+    g_object_unref(index);
+    return dt;
+}
 
 GArrowSchema* aw_build_schema(const ColumnSpec *cols, int ncols) {
     GList *fields = NULL;
     for (int i = 0; i < ncols; i++) {
         GArrowDataType *dt = NULL;
         switch (cols[i].kind) {
-            case COL_UTF8:    dt = (GArrowDataType*)garrow_string_data_type_new();  break;
+            case COL_UTF8:
+                dt = cols[i].dict ? dict_type() : (GArrowDataType*)garrow_string_data_type_new();
+                break;
             case COL_BOOL:    dt = (GArrowDataType*)garrow_boolean_data_type_new(); break;
+            case COL_INT8:    dt = (GArrowDataType*)garrow_int8_data_type_new();    break;
+            case COL_INT16:   dt = (GArrowDataType*)garrow_int16_data_type_new();   break;
+            case COL_INT32:   dt = (GArrowDataType*)garrow_int32_data_type_new();   break;
             case COL_INT64:   dt = (GArrowDataType*)garrow_int64_data_type_new();   break;
             case COL_FLOAT64: dt = (GArrowDataType*)garrow_double_data_type_new();  break;
             case COL_DATE32:  dt = (GArrowDataType*)garrow_date32_data_type_new();  break;
+            case COL_DECIMAL128:
+                dt = (GArrowDataType*)garrow_decimal128_data_type_new(dbf_decimal_precision(&cols[i]),
+                                                                      cols[i].decimals, NULL);
+                break;
             default:          dt = (GArrowDataType*)garrow_string_data_type_new();  break;
         }
         /* garrow_field_new assume ownership de dt */
@@ -27,124 +47,261 @@ GArrowSchema* aw_build_schema(const ColumnSpec *cols, int ncols) {
 
 
 
-void aw_make_builders(GArrowSchema *schema, GPtrArray **out_builders) {
-    int ncols = garrow_schema_n_fields(schema);
-    GPtrArray *builders = g_ptr_array_new_with_free_func(g_object_unref);
-    for (int i = 0; i < ncols; i++) {
-        GArrowField *field = garrow_schema_get_field(schema, i);
-        GArrowDataType *dt = garrow_field_get_data_type(field);
-        GArrowArrayBuilder *b = NULL;
-
-        if (GARROW_IS_STRING_DATA_TYPE(dt)) {
-            b = (GArrowArrayBuilder*)garrow_string_array_builder_new();
-        } else if (GARROW_IS_BOOLEAN_DATA_TYPE(dt)) {
-            b = (GArrowArrayBuilder*)garrow_boolean_array_builder_new();
-        } else if (GARROW_IS_INT64_DATA_TYPE(dt)) {
-            b = (GArrowArrayBuilder*)garrow_int64_array_builder_new();
-        } else if (GARROW_IS_DOUBLE_DATA_TYPE(dt)) {
-            b = (GArrowArrayBuilder*)garrow_double_array_builder_new();
-        } else if (GARROW_IS_DATE32_DATA_TYPE(dt)) {
-            b = (GArrowArrayBuilder*)garrow_date32_array_builder_new();
-        } else {
-            b = (GArrowArrayBuilder*)garrow_string_array_builder_new();
-        }
-
-        g_ptr_array_add(builders, b);
-        /* NÃO dar unref(dt) nem unref(field) – são borrowed. */
-    }
-    *out_builders = builders;
+/* Buffer Arrow que assume um bloco malloc (liberado junto com o buffer) */
+static GArrowBuffer* take_buffer(void *data, size_t len) {
+    GBytes *bytes = g_bytes_new_with_free_func(data, len, free, data);
+    GArrowBuffer *buf = garrow_buffer_new_bytes(bytes);
+    g_bytes_unref(bytes);
+    return buf;
 }
 
+static void free_array_list(gpointer list) {
+    g_list_free_full((GList*)list, g_object_unref);
+}
 
-int aw_append_row(GPtrArray *builders,
-                  const ColumnSpec *cols, int ncols,
-                  const DbfCtx *ctx, int row,
-                  const char *from_cp, int strict)
-{
-    for (int c = 0; c < ncols; c++) {
-        GArrowArrayBuilder *b = g_ptr_array_index(builders, c);
-        char *s = NULL; long long i64 = 0; double f64 = 0.0; int bval = 0; int i32 = 0;
-
-        int is_null = dbf_read_value(ctx, &cols[c], c, row, from_cp, strict,
-                                     &s, &i64, &f64, &bval, &i32);
-        if (is_null < 0) return -1;
+/* Array Arrow a partir dos buffers de uma coluna (zero-copy) */
+static GArrowArray* wrap_column(const ColumnSpec *col, ColBuf *b) {
+    GArrowBuffer *validity = b->validity ? take_buffer(b->validity, ((size_t)b->nrows + 7) / 8) : NULL;
+    GArrowBuffer *values   = take_buffer(b->values, b->values_len);
+    GArrowArray *arr = NULL;
+    gint64 n = b->nrows;
 
-        switch (cols[c].kind) {
-            case COL_UTF8:
-            default: {
-                GArrowStringArrayBuilder *sb = GARROW_STRING_ARRAY_BUILDER(b);
-                if (is_null) garrow_array_builder_append_null(b, NULL);
-                else         garrow_string_array_builder_append_string(sb, s, NULL);
-                if (s) free(s);
-                break;
-            }
-            case COL_BOOL: {
-                GArrowBooleanArrayBuilder *bb = GARROW_BOOLEAN_ARRAY_BUILDER(b);
-                if (is_null) garrow_array_builder_append_null(b, NULL);
-                else         garrow_boolean_array_builder_append_value(bb, bval, NULL);
-                break;
-            }
-            case COL_INT64: {
-                GArrowInt64ArrayBuilder *ib = GARROW_INT64_ARRAY_BUILDER(b);
-                if (is_null) garrow_array_builder_append_null(b, NULL);
-                else         garrow_int64_array_builder_append_value(ib, i64, NULL);
-                break;
-            }
-            case COL_FLOAT64: {
-                GArrowDoubleArrayBuilder *db = GARROW_DOUBLE_ARRAY_BUILDER(b);
-                if (is_null) garrow_array_builder_append_null(b, NULL);
-                else         garrow_double_array_builder_append_value(db, f64, NULL);
-                break;
-            }
-            case COL_DATE32: {
-                GArrowDate32ArrayBuilder *db = GARROW_DATE32_ARRAY_BUILDER(b);
-                if (is_null) garrow_array_builder_append_null(b, NULL);
-                else         garrow_date32_array_builder_append_value(db, i32, NULL);
+    switch (col->kind) {
+        case COL_UTF8:
+        default: {
+            GArrowBuffer *data = take_buffer(b->data, b->data_len);
+            if (col->dict) {
+                /* índices int32 + valores distintos do lote (uma página de
+                   dicionário pronta para o Parquet por row group) */
+                GArrowBuffer *offs = take_buffer(b->dict_offsets, ((size_t)b->ndict + 1) * sizeof(int32_t));
+                GArrowArray *indices = GARROW_ARRAY(garrow_int32_array_new(n, values, validity, b->nnulls));
+                GArrowArray *dict = GARROW_ARRAY(garrow_string_array_new(b->ndict, offs, data, NULL, 0));
+                GArrowDataType *dt = dict_type();
+                arr = indices && dict ? GARROW_ARRAY(garrow_dictionary_array_new(dt, indices, dict, NULL)) : NULL;
+                /* o array de dicionário não segura os GArrowBuffer: os filhos seguram */
+                if (arr) {
+                    g_object_set_data_full(G_OBJECT(arr), "dbf2parquet-indices", indices, g_object_unref);
+                    g_object_set_data_full(G_OBJECT(arr), "dbf2parquet-dictionary", dict, g_object_unref);
+                } else {
+                    if (indices) g_object_unref(indices);
+                    if (dict) g_object_unref(dict);
+                }
+                g_object_unref(dt);
+                g_object_unref(offs);
+                g_object_unref(data);
                 break;
             }
+            arr = GARROW_ARRAY(garrow_string_array_new(n, values, data, validity, b->nnulls));
+            g_object_unref(data);
+            break;
+        }
+        case COL_BOOL:
+            arr = GARROW_ARRAY(garrow_boolean_array_new(n, values, validity, b->nnulls));
+            break;
+        case COL_INT8:
+            arr = GARROW_ARRAY(garrow_int8_array_new(n, values, validity, b->nnulls));
+            break;
+        case COL_INT16:
+            arr = GARROW_ARRAY(garrow_int16_array_new(n, values, validity, b->nnulls));
+            break;
+        case COL_INT32:
+            arr = GARROW_ARRAY(garrow_int32_array_new(n, values, validity, b->nnulls));
+            break;
+        case COL_INT64:
+            arr = GARROW_ARRAY(garrow_int64_array_new(n, values, validity, b->nnulls));
+            break;
+        case COL_FLOAT64:
+            arr = GARROW_ARRAY(garrow_double_array_new(n, values, validity, b->nnulls));
+            break;
+        case COL_DATE32:
+            arr = GARROW_ARRAY(garrow_date32_array_new(n, values, validity, b->nnulls));
+            break;
+        case COL_DECIMAL128: {
+            /* sem construtor de decimal128 a partir de buffers: fixed_size_binary(16)
+               sobre os mesmos bytes, reinterpretado com garrow_array_view() */
+            GArrowFixedSizeBinaryDataType *fdt = garrow_fixed_size_binary_data_type_new(16);
+            GArrowArray *raw = GARROW_ARRAY(garrow_fixed_size_binary_array_new(fdt, n, values, validity, b->nnulls));
+            GArrowDataType *ddt = GARROW_DATA_TYPE(
+                garrow_decimal128_data_type_new(dbf_decimal_precision(col), col->decimals, NULL));
+            arr = raw && ddt ? garrow_array_view(raw, ddt, NULL) : NULL;
+            /* a visão não segura os GArrowBuffer: quem segura é `raw` */
+            if (arr) g_object_set_data_full(G_OBJECT(arr), "dbf2parquet-raw", raw, g_object_unref);
+            else if (raw) g_object_unref(raw);
+            if (ddt) g_object_unref(ddt);
+            g_object_unref(fdt);
+            break;
         }
     }
-    return 0;
+
+    /* os GObjects dos arrays mantêm referência aos buffers */
+    g_object_unref(values);
+    if (validity) g_object_unref(validity);
+    memset(b, 0, sizeof(*b));
+    return arr;
 }
 
-GArrowRecordBatch* aw_finish_batch(GArrowSchema *schema, GPtrArray *builders) {
-    int ncols = garrow_schema_n_fields(schema);
+GArrowRecordBatch* aw_finish_batch(GArrowSchema *schema,
+                                   const ColumnSpec *cols, ColBuf *bufs, int ncols,
+                                   int nrows) {
     GList *arrays = NULL;
-
+    int ok = 1;
     for (int i = 0; i < ncols; i++) {
-        GArrowArrayBuilder *b = g_ptr_array_index(builders, i);
-        GError *error = NULL;
-        GArrowArray *arr = garrow_array_builder_finish(b, &error);
-        if (!arr) {
-            if (error) g_error_free(error);
-            return NULL;
-        }
+        GArrowArray *arr = wrap_column(&cols[i], &bufs[i]);
+        if (!arr) { ok = 0; continue; } /* buffers já entregues; segue liberando os demais */
         arrays = g_list_append(arrays, arr);
     }
+    if (!ok) {
+        g_list_free_full(arrays, g_object_unref);
+        return NULL;
+    }
 
-    gint64 nrows = garrow_array_get_length(GARROW_ARRAY(g_list_last(arrays)->data));
     GError *error = NULL;
     /* API 21.x: recebe schema, nrows, lista de arrays, e GError** */
-    GArrowRecordBatch *batch = garrow_record_batch_new(schema, nrows, arrays, &error);
-    /* O record batch assume ownership dos arrays; só liberamos a lista */
-    g_list_free(arrays);
+    GArrowRecordBatch *batch = garrow_record_batch_new(schema, (guint32)nrows, arrays, &error);
+
+    if (!batch) {
+        g_list_free_full(arrays, g_object_unref);
+        if (error) { g_printerr("record batch error: %s\n", error->message); g_error_free(error); }
+        return NULL;
+    }
+
+    /* Os GArrowBuffer (GBytes sobre nossa memória) vivem nos GObjects dos arrays,
+       não nos shared_ptr do C++: o batch segura os arrays até ser liberado. */
+    g_object_set_data_full(G_OBJECT(batch), "dbf2parquet-columns", arrays, free_array_list);
+    return batch;
+}
+
+int aw_decode_batch(GArrowSchema *schema,
+                    const ColumnSpec *cols, int ncols,
+                    const DbfCtx *ctx, int row, const int *sel, int nsel,
+                    EncCtx *enc, int strict,
+                    GArrowRecordBatch **out, int *err_row)
+{
+    *out = NULL;
+    ColBuf *bufs = (ColBuf*)calloc((size_t)(ncols ? ncols : 1), sizeof(ColBuf));
+    if (!bufs) return -2;
+
+    for (int c = 0; c < ncols; c++) {
+        int rc = dbf_decode_column(ctx, &cols[c], row, sel, nsel, enc, strict, &bufs[c], err_row);
+        if (rc != 0) {
+            for (int j = 0; j < c; j++) colbuf_free(&bufs[j]);
+            free(bufs);
+            return rc == -1 || rc == -3 ? rc : -2;
+        }
+    }
+
+    *out = aw_finish_batch(schema, cols, bufs, ncols, nsel);
+    free(bufs);
+    return *out ? 0 : -2;
+}
+
+GArrowRecordBatch* aw_concat_batches(GArrowSchema *schema, GArrowRecordBatch **batches, int n) {
+    GError *error = NULL;
+    GArrowTable *table = garrow_table_new_record_batches(schema, batches, (gsize)n, &error);
+    GArrowTable *combined = NULL;
+    if (table) {
+        /* um chunk por coluna (dicionários diferentes são unificados) */
+        combined = garrow_table_combine_chunks(table, &error);
+        g_object_unref(table);
+    }
+    if (!combined) {
+        if (error) { g_printerr("concat batches error: %s\n", error->message); g_error_free(error); }
+        return NULL;
+    }
+
+    GList *arrays = NULL;
+    gint ncols = garrow_schema_n_fields(schema);
+    for (gint i = 0; i < ncols; i++) {
+        GArrowChunkedArray *ca = garrow_table_get_column_data(combined, i);
+        arrays = g_list_append(arrays, garrow_chunked_array_get_chunk(ca, 0));
+        g_object_unref(ca);
+    }
+    guint64 nrows = garrow_table_get_n_rows(combined);
+    g_object_unref(combined);
 
+    GArrowRecordBatch *batch = garrow_record_batch_new(schema, (guint32)nrows, arrays, &error);
+    g_list_free_full(arrays, g_object_unref);
     if (!batch) {
-        if (error) g_error_free(error);
+        if (error) { g_printerr("concat batches error: %s\n", error->message); g_error_free(error); }
         return NULL;
     }
+
+    /* um dicionário igual nos lotes pode ser reaproveitado sem cópia: os lotes
+       de origem (e seus buffers zero-copy) vivem enquanto o resultado viver */
+    GList *sources = NULL;
+    for (int i = 0; i < n; i++) sources = g_list_append(sources, g_object_ref(batches[i]));
+    g_object_set_data_full(G_OBJECT(batch), "dbf2parquet-sources", sources, free_array_list);
     return batch;
 }
 
-int aw_write_parquet(const char *out_path, GArrowSchema *schema, GPtrArray *batches) {
+static const struct {
+    const char           *name;
+    GArrowCompressionType type;
+} codec_names[] = {
+    { "none",         GARROW_COMPRESSION_TYPE_UNCOMPRESSED },
+    { "uncompressed", GARROW_COMPRESSION_TYPE_UNCOMPRESSED },
+    { "snappy",       GARROW_COMPRESSION_TYPE_SNAPPY },
+    { "gzip",         GARROW_COMPRESSION_TYPE_GZIP },
+    { "brotli",       GARROW_COMPRESSION_TYPE_BROTLI },
+    { "zstd",         GARROW_COMPRESSION_TYPE_ZSTD },
+    { "lz4",          GARROW_COMPRESSION_TYPE_LZ4 },
+};
+
+int aw_parse_compression(const char *name, GArrowCompressionType *out) {
+    for (size_t i = 0; i < sizeof(codec_names) / sizeof(codec_names[0]); i++) {
+        if (g_ascii_strcasecmp(name, codec_names[i].name) == 0) {
+            *out = codec_names[i].type;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+void aw_write_opts_init(AwWriteOpts *wo) {
+    memset(wo, 0, sizeof(*wo));
+    wo->compression = GARROW_COMPRESSION_TYPE_SNAPPY;
+}
+
+int aw_unknown_codec_column(const AwWriteOpts *wo, const ColumnSpec *cols, int ncols) {
+    for (int i = 0; i < wo->ncolumn_codecs; i++) {
+        int found = 0;
+        for (int c = 0; c < ncols && !found; c++)
+            found = strcmp(cols[c].name, wo->column_codecs[i].column) == 0;
+        if (!found) return i;
+    }
+    return -1;
+}
+
+char* aw_part_path(const char *output, int part) {
+    char *base = g_strdup(output);
+    char *dot = strrchr(base, '.');
+    char *slash = strrchr(base, G_DIR_SEPARATOR);
+    if (dot && (!slash || dot > slash + 1) && g_ascii_strcasecmp(dot, ".parquet") == 0) *dot = '\0';
+    char *path = g_strdup_printf("%s-%05d.parquet", base, part);
+    g_free(base);
+    return path;
+}
+
+GParquetArrowFileWriter* aw_open_parquet(const char *out_path, GArrowSchema *schema,
+                                         const AwWriteOpts *wo) {
     GError *error = NULL;
+    AwWriteOpts defaults;
+    if (!wo) {
+        aw_write_opts_init(&defaults);
+        wo = &defaults;
+    }
 
-    /* Writer properties (API v21): usa GArrowCompressionType + path (NULL = default global) */
+    /* Writer properties (API v21): usa GArrowCompressionType + path (NULL = default global;
+       o path de uma coluna de topo é o próprio nome) */
     GParquetWriterProperties *wprops = gparquet_writer_properties_new();
-    /* Se sua build não tiver Snappy, troque por GARROW_COMPRESSION_TYPE_ZSTD ou _GZIP */
-    gparquet_writer_properties_set_compression(wprops,
-                                               GARROW_COMPRESSION_TYPE_SNAPPY,
-                                               NULL);
+    gparquet_writer_properties_set_compression(wprops, wo->compression, NULL);
+    for (int i = 0; i < wo->ncolumn_codecs; i++)
+        gparquet_writer_properties_set_compression(wprops, wo->column_codecs[i].codec,
+                                                   wo->column_codecs[i].column);
+    if (wo->data_page_size > 0)
+        gparquet_writer_properties_set_data_page_size(wprops, wo->data_page_size);
+    if (wo->dictionary_page_size > 0)
+        gparquet_writer_properties_set_dictionary_page_size_limit(wprops, wo->dictionary_page_size);
 
     /* Cria writer com propriedades */
     GParquetArrowFileWriter *writer =
@@ -153,19 +310,38 @@ int aw_write_parquet(const char *out_path, GArrowSchema *schema, GPtrArray *batc
 
     if (!writer) {
         if (error) { g_printerr("parquet writer error: %s\n", error->message); g_error_free(error); }
+        return NULL;
+    }
+    return writer;
+}
+
+int aw_write_batch(GParquetArrowFileWriter *writer, GArrowRecordBatch *batch) {
+    GError *error = NULL;
+    gint64 nrows = garrow_record_batch_get_n_rows(batch);
+    if (nrows == 0) return 0;
+
+    /* write_record_batch() acumula batches num row group "buffered" em memória
+       até max_row_group_length; write_table() abre um row group novo e grava
+       as colunas na hora. Um table de 1 batch = 1 row group já no disco. */
+    GArrowSchema *schema = garrow_record_batch_get_schema(batch);
+    GArrowTable *table = garrow_table_new_record_batches(schema, &batch, 1, &error);
+    g_object_unref(schema);
+    if (!table) {
+        if (error) { g_printerr("write batch error: %s\n", error->message); g_error_free(error); }
         return -1;
     }
 
-    /* 1 row group por RecordBatch */
-    for (guint i = 0; i < batches->len; i++) {
-        GArrowRecordBatch *batch = g_ptr_array_index(batches, i);
-        if (!gparquet_arrow_file_writer_write_record_batch(writer, batch, &error)) {
-            g_object_unref(writer);
-            if (error) { g_printerr("write batch error: %s\n", error->message); g_error_free(error); }
-            return -2;
-        }
+    gboolean ok = gparquet_arrow_file_writer_write_table(writer, table, (gsize)nrows, &error);
+    g_object_unref(table);
+    if (!ok) {
+        if (error) { g_printerr("write batch error: %s\n", error->message); g_error_free(error); }
+        return -2;
     }
+    return 0;
+}
 
+int aw_close_parquet(GParquetArrowFileWriter *writer) {
+    GError *error = NULL;
     if (!gparquet_arrow_file_writer_close(writer, &error)) {
         g_object_unref(writer);
         if (error) { g_printerr("close writer error: %s\n", error->message); g_error_free(error); }
@@ -175,4 +351,24 @@ int aw_write_parquet(const char *out_path, GArrowSchema *schema, GPtrArray *batc
     return 0;
 }
 
-
+int aw_append_parquet(GParquetArrowFileWriter *writer, const char *path) {
+    GError *error = NULL;
+    GParquetArrowFileReader *reader = gparquet_arrow_file_reader_new_path(path, &error);
+    if (!reader) {
+        if (error) { g_printerr("append %s: %s\n", path, error->message); g_error_free(error); }
+        return -1;
+    }
+    int rc = 0;
+    gint n = gparquet_arrow_file_reader_get_n_row_groups(reader);
+    for (gint i = 0; rc == 0 && i < n; i++) {
+        GArrowTable *table = gparquet_arrow_file_reader_read_row_group(reader, i, NULL, 0, &error);
+        if (!table) { rc = -1; break; }
+        guint64 nrows = garrow_table_get_n_rows(table);
+        if (nrows > 0 && !gparquet_arrow_file_writer_write_table(writer, table, (gsize)nrows, &error))
+            rc = -2;
+        g_object_unref(table);
+    }
+    if (error) { g_printerr("append %s: %s\n", path, error->message); g_error_free(error); }
+    g_object_unref(reader);
+    return rc;
+}
@@ -5,22 +5,73 @@
 #include <parquet-glib/parquet-glib.h>
 #include "dbf_reader.h"
 
+/* Codec de uma coluna específica (--column-compression COL=codec) */
+typedef struct {
+    char                 *column;   /* nome da coluna (g_free) */
+    GArrowCompressionType codec;
+} AwColumnCodec;
+
+/* Propriedades do writer Parquet (aw_write_opts_init: Snappy, páginas no default do Parquet) */
+typedef struct {
+    GArrowCompressionType compression;      /* codec das colunas sem override */
+    const AwColumnCodec  *column_codecs;
+    int                   ncolumn_codecs;
+    gint64                data_page_size;       /* bytes por página de dados (0 = default) */
+    gint64                dictionary_page_size; /* limite da página de dicionário (0 = default);
+                                                   acima dele a coluna volta a PLAIN */
+} AwWriteOpts;
+
+/* Nome do codec ('none'/'uncompressed', 'snappy', 'gzip', 'brotli', 'zstd',
+   'lz4') → tipo Arrow. Retorna 0 ok, -1 nome desconhecido. */
+int aw_parse_compression(const char *name, GArrowCompressionType *out);
+
+/* Inicializa com os defaults (Snappy). */
+void aw_write_opts_init(AwWriteOpts *wo);
+
+/* Índice em wo->column_codecs da 1ª coluna que não está em `cols` (-1 = todas existem). */
+int aw_unknown_codec_column(const AwWriteOpts *wo, const ColumnSpec *cols, int ncols);
+
+/* Nome da parte `part` (1, 2, ...) de uma saída dividida:
+   "saida.parquet" → "saida-00001.parquet" (g_free). */
+char* aw_part_path(const char *output, int part);
+
 /* Constrói o schema Arrow a partir das colunas DBF */
 GArrowSchema* aw_build_schema(const ColumnSpec *cols, int ncols);
 
-/* Cria array builders conforme o schema (mesma ordem das colunas) */
-void aw_make_builders(GArrowSchema *schema, GPtrArray **out_builders);
+/* Envolve os buffers decodificados (um ColBuf por coluna) em arrays Arrow sem
+   copiar e empacota num RecordBatch. Os buffers passam a pertencer ao Arrow
+   (bufs[] fica zerado), inclusive em caso de erro. */
+GArrowRecordBatch* aw_finish_batch(GArrowSchema *schema,
+                                   const ColumnSpec *cols, ColBuf *bufs, int ncols,
+                                   int nrows);
+
+/* Decodifica o lote [row, row + n) coluna a coluna (só as linhas de `sel`,
+   ou todas se sel == NULL) e monta o RecordBatch em *out.
+   Retorna 0 ok; -1 erro de conversão (strict) na linha *err_row; -3 inteiro
+   fora da faixa da amostra (--infer sample) na linha *err_row; -2 erro interno. */
+int aw_decode_batch(GArrowSchema *schema,
+                    const ColumnSpec *cols, int ncols,
+                    const DbfCtx *ctx, int row, const int *sel, int nsel,
+                    EncCtx *enc, int strict,
+                    GArrowRecordBatch **out, int *err_row);
+
+/* Junta `n` RecordBatches de `schema`, em ordem, num só (copia os valores;
+   um chunk por coluna). Para reunir lotes pequenos num row group. NULL em erro. */
+GArrowRecordBatch* aw_concat_batches(GArrowSchema *schema, GArrowRecordBatch **batches, int n);
+
+/* Abre o writer Parquet (streaming) com as propriedades de `wo` (NULL = defaults):
+   cada batch escrito vira um row group no disco */
+GParquetArrowFileWriter* aw_open_parquet(const char *out_path, GArrowSchema *schema,
+                                         const AwWriteOpts *wo);
 
-/* Faz append de uma linha (valores da linha corrente) nos builders */
-int aw_append_row(GPtrArray *builders,
-                  const ColumnSpec *cols, int ncols,
-                  const DbfCtx *ctx, int row,
-                  const char *from_cp, int strict);
+/* Escreve um RecordBatch como row group próprio (não bufferiza entre chamadas) */
+int aw_write_batch(GParquetArrowFileWriter *writer, GArrowRecordBatch *batch);
 
-/* Finaliza builders em arrays e empacota num RecordBatch */
-GArrowRecordBatch* aw_finish_batch(GArrowSchema *schema, GPtrArray *builders);
+/* Grava o footer, fecha e libera o writer */
+int aw_close_parquet(GParquetArrowFileWriter *writer);
 
-/* Escreve uma lista de RecordBatches em Parquet Snappy */
-int aw_write_parquet(const char *out_path, GArrowSchema *schema, GPtrArray *batches);
+/* Copia os row groups do Parquet `path` (mesmo schema) para `writer`, um row
+   group de saída para cada um de entrada. Retorna 0 ok, < 0 erro. */
+int aw_append_parquet(GParquetArrowFileWriter *writer, const char *path);
 
 #endif
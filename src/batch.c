@@ -0,0 +1,214 @@
+#include "batch.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+/* .dbf / .dbc (case-insensitive) */
+static int is_dbf_name(const char *name) {
+    const char *dot = strrchr(name, '.');
+    if (!dot) return 0;
+    return g_ascii_strcasecmp(dot, ".dbf") == 0 || g_ascii_strcasecmp(dot, ".dbc") == 0;
+}
+
+static gint cmp_path(gconstpointer a, gconstpointer b) {
+    return strcmp(*(char* const*)a, *(char* const*)b);
+}
+
+/* Arquivos de `dir` cujo nome casa com `pattern` (ou .dbf/.dbc se NULL), em
+   ordem alfabética */
+static int list_dir(const char *dir, const char *pattern, GPtrArray *paths) {
+    GError *err = NULL;
+    GDir *d = g_dir_open(dir, 0, &err);
+    if (!d) {
+        fprintf(stderr, "batch: não consegui abrir o diretório '%s': %s\n", dir, err->message);
+        g_error_free(err);
+        return -1;
+    }
+    GPtrArray *found = g_ptr_array_new();
+    const char *name;
+    while ((name = g_dir_read_name(d)) != NULL) {
+        int ok = pattern ? g_pattern_match_simple(pattern, name) : is_dbf_name(name);
+        if (!ok) continue;
+        char *path = g_build_filename(dir, name, NULL);
+        if (g_file_test(path, G_FILE_TEST_IS_REGULAR)) g_ptr_array_add(found, path);
+        else g_free(path);
+    }
+    g_dir_close(d);
+
+    g_ptr_array_sort(found, cmp_path);
+    for (guint i = 0; i < found->len; i++) g_ptr_array_add(paths, g_ptr_array_index(found, i));
+    g_ptr_array_free(found, TRUE);
+    return 0;
+}
+
+/* Uma entrada por linha; ignora linhas vazias e comentários (#) */
+static int read_list(const char *list_file, GPtrArray *paths) {
+    FILE *f = fopen(list_file, "r");
+    if (!f) {
+        fprintf(stderr, "batch: não consegui abrir a lista '%s': %s\n", list_file, strerror(errno));
+        return -1;
+    }
+    char line[4096];
+    while (fgets(line, sizeof(line), f)) {
+        char *p = g_strstrip(line);
+        if (*p == '\0' || *p == '#') continue;
+        g_ptr_array_add(paths, g_strdup(p));
+    }
+    fclose(f);
+    return 0;
+}
+
+int batch_collect(const char *dir, const char *pattern, const char *list_file, GPtrArray *paths) {
+    if (dir && list_dir(dir, NULL, paths) != 0) return -1;
+
+    if (pattern) {
+        /* curingas só no nome do arquivo: "dados/RD*.dbc" */
+        char *pdir  = g_path_get_dirname(pattern);
+        char *pbase = g_path_get_basename(pattern);
+        int rc = list_dir(pdir, pbase, paths);
+        g_free(pbase);
+        g_free(pdir);
+        if (rc != 0) return -1;
+    }
+
+    if (list_file && read_list(list_file, paths) != 0) return -1;
+    return 0;
+}
+
+BatchItem* batch_items(GPtrArray *paths, const char *output_dir, int *n_out) {
+    if (g_mkdir_with_parents(output_dir, 0755) != 0) {
+        fprintf(stderr, "batch: não consegui criar '%s': %s\n", output_dir, strerror(errno));
+        return NULL;
+    }
+
+    int n = (int)paths->len;
+    BatchItem *items = g_new0(BatchItem, n ? n : 1);
+    GHashTable *seen = g_hash_table_new(g_str_hash, g_str_equal);
+    for (int i = 0; i < n; i++) {
+        const char *in = g_ptr_array_index(paths, i);
+        char *base = g_path_get_basename(in);
+        char *dot = strrchr(base, '.');
+        if (dot && dot != base) *dot = '\0';
+        char *name = g_strconcat(base, ".parquet", NULL);
+        g_free(base);
+
+        items[i].input  = g_strdup(in);
+        items[i].output = g_build_filename(output_dir, name, NULL);
+        items[i].rc     = -1;
+        g_free(name);
+
+        /* duas entradas com o mesmo nome base sobrescreveriam a mesma saída */
+        const char *prev = g_hash_table_lookup(seen, items[i].output);
+        if (prev) {
+            fprintf(stderr, "batch: '%s' e '%s' gerariam a mesma saída '%s'\n",
+                    prev, in, items[i].output);
+            g_hash_table_destroy(seen);
+            batch_free(items, i + 1);
+            return NULL;
+        }
+        g_hash_table_insert(seen, items[i].output, items[i].input);
+    }
+    g_hash_table_destroy(seen);
+    *n_out = n;
+    return items;
+}
+
+void batch_free(BatchItem *items, int n) {
+    if (!items) return;
+    for (int i = 0; i < n; i++) {
+        g_free(items[i].input);
+        g_free(items[i].output);
+    }
+    g_free(items);
+}
+
+/* Readahead assíncrono do arquivo inteiro (só uma dica ao kernel) */
+static void prefetch_file(const char *path) {
+#if defined(_WIN32) || !defined(POSIX_FADV_WILLNEED)
+    (void)path; /* sem equivalente simples; o FILE_FLAG_SEQUENTIAL_SCAN do dbf_open ajuda */
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return;
+    posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+    close(fd);
+#endif
+}
+
+/* --- pool de threads: fila única, um arquivo por vez por thread --- */
+typedef struct {
+    BatchItem *items;
+    int        n;
+    BatchFn    fn;
+    void      *user;
+    GMutex     lock;
+    int        next;         /* próximo item a distribuir */
+} Pool;
+
+static gpointer pool_main(gpointer data) {
+    Pool *p = (Pool*)data;
+    for (;;) {
+        g_mutex_lock(&p->lock);
+        int i = p->next < p->n ? p->next++ : -1;
+        int ahead = p->next < p->n ? p->next : -1;
+        g_mutex_unlock(&p->lock);
+        if (i < 0) break;
+
+        if (ahead >= 0) prefetch_file(p->items[ahead].input);
+
+        gint64 t0 = g_get_monotonic_time();
+        p->fn(&p->items[i], p->user);
+        p->items[i].secs = (double)(g_get_monotonic_time() - t0) / 1e6;
+    }
+    return NULL;
+}
+
+void batch_run(BatchItem *items, int n, int jobs, BatchFn fn, void *user) {
+    Pool p;
+    memset(&p, 0, sizeof(p));
+    p.items = items;
+    p.n = n;
+    p.fn = fn;
+    p.user = user;
+    g_mutex_init(&p.lock);
+
+    if (jobs > n) jobs = n;
+    if (jobs <= 1) {
+        pool_main(&p);
+    } else {
+        GThread **threads = g_new0(GThread*, jobs);
+        for (int t = 0; t < jobs; t++)
+            threads[t] = g_thread_new("dbf2parquet-file", pool_main, &p);
+        for (int t = 0; t < jobs; t++) g_thread_join(threads[t]);
+        g_free(threads);
+    }
+    g_mutex_clear(&p.lock);
+}
+
+int batch_report(const BatchItem *items, int n, FILE *out) {
+    int failed = 0;
+    long long records = 0;
+    double secs = 0;
+    fprintf(out, "\nResumo (%d arquivos):\n", n);
+    for (int i = 0; i < n; i++) {
+        const BatchItem *it = &items[i];
+        if (it->rc == 0) {
+            fprintf(out, "  OK     %s -> %s (%lld registros, %.2fs)\n",
+                    it->input, it->output, it->records, it->secs);
+            records += it->records;
+        } else {
+            fprintf(out, "  FALHA  %s: %s (código %d)\n", it->input,
+                    it->msg[0] ? it->msg : "não processado", it->rc);
+            failed++;
+        }
+        secs += it->secs;
+    }
+    fprintf(out, "%d ok, %d com falha; %lld registros convertidos (%.2fs somando os arquivos)\n",
+            n - failed, failed, records, secs);
+    return failed;
+}
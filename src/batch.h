@@ -0,0 +1,40 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <stdio.h>
+#include <glib.h>
+
+/* Um arquivo do modo lote (--input-dir / --input-glob / --input-list) */
+typedef struct {
+    char      *input;
+    char      *output;       /* <output-dir>/<nome sem extensão>.parquet */
+    int        rc;           /* código de saída da conversão (-1 = não processado) */
+    char       msg[256];     /* mensagem de erro quando rc != 0 */
+    long long  records;      /* registros lidos */
+    double     secs;
+} BatchItem;
+
+/* Converte item->input em item->output; preenche rc/msg/records.
+   Chamada em paralelo por várias threads (uma por arquivo). */
+typedef void (*BatchFn)(BatchItem *item, void *user);
+
+/* Acrescenta a `paths` (g_free) os .dbf/.dbc de `dir` (sem recursão), os
+   arquivos que casam com `pattern` (curingas * e ? só no nome do arquivo) e
+   as linhas de `list_file` (um caminho por linha; vazias e '#' ignoradas).
+   Qualquer um pode ser NULL. Retorna 0 ok, -1 erro (mensagem no stderr). */
+int batch_collect(const char *dir, const char *pattern, const char *list_file, GPtrArray *paths);
+
+/* Monta os itens (saídas em `output_dir`, criado se preciso). Retorna o vetor
+   (batch_free) ou NULL em erro; duas entradas com o mesmo nome base são erro. */
+BatchItem* batch_items(GPtrArray *paths, const char *output_dir, int *n_out);
+void batch_free(BatchItem *items, int n);
+
+/* Converte todos os itens com `jobs` threads, um arquivo por thread. Ao
+   pegar um arquivo, a thread pede readahead do próximo da fila, que já está
+   no cache quando alguém o pegar. */
+void batch_run(BatchItem *items, int n, int jobs, BatchFn fn, void *user);
+
+/* Resumo por arquivo + totais. Retorna o nº de falhas. */
+int batch_report(const BatchItem *items, int n, FILE *out);
+
+#endif
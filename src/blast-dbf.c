@@ -20,6 +20,8 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <time.h>
 #include <unistd.h>
 #include <stdint.h>
 
@@ -27,13 +29,19 @@
 
 #define CHUNK 4096
 
+/* Input file and its read buffer (one per call: no static state) */
+struct input {
+    FILE *file;
+    unsigned char hold[CHUNK];
+};
+
 /* Input file helper function */
 static unsigned inf(void *how, unsigned char **buf)
 {
-    static unsigned char hold[CHUNK];
+    struct input *in = (struct input *)how;
 
-    *buf = hold;
-    return fread(hold, 1, CHUNK, (FILE *)how);
+    *buf = in->hold;
+    return fread(in->hold, 1, CHUNK, in->file);
 }
 
 /* Output file helper function */
@@ -76,7 +84,9 @@ int dbc2dbf(FILE* input, FILE* output) {
     err = ferror(input);
 
     /* decompress */
-    ret = blast(inf, input, outf, output);
+    struct input in;
+    in.file = input;
+    ret = blast(inf, &in, outf, output);
     if (ret != 0) fprintf(stderr, "blast error: %d\n", ret);
 
     /* see if there are any leftover bytes */
@@ -88,10 +98,138 @@ int dbc2dbf(FILE* input, FILE* output) {
     return ret;
 }
 
+#ifdef BLAST_REFERENCE
+/* In-memory input and hashing output for --compare */
+struct memin {
+    unsigned char *data;
+    size_t len, pos;
+};
+
+struct digest {
+    uint64_t hash;      /* FNV-1a of the output */
+    uint64_t bytes;
+};
+
+static unsigned meminf(void *how, unsigned char **buf)
+{
+    struct memin *in = (struct memin *)how;
+    size_t n = in->len - in->pos;
+
+    if (n > CHUNK) n = CHUNK;
+    *buf = in->data + in->pos;
+    in->pos += n;
+    return (unsigned)n;
+}
+
+static int digestf(void *how, unsigned char *buf, unsigned len)
+{
+    struct digest *d = (struct digest *)how;
+    unsigned i;
+
+    for (i = 0; i < len; i++)
+        d->hash = (d->hash ^ buf[i]) * 0x100000001b3ULL;
+    d->bytes += len;
+    return 0;
+}
+
+/* Decompress the DCL stream of a .dbc with one decoder; returns seconds */
+static double timed(int (*dec)(blast_in, void *, blast_out, void *),
+                    unsigned char *data, size_t len, size_t start,
+                    struct digest *d, int *ret)
+{
+    struct memin in;
+    clock_t t0;
+
+    in.data = data;
+    in.len = len;
+    in.pos = start;
+    d->hash = 0xcbf29ce484222325ULL;
+    d->bytes = 0;
+    t0 = clock();
+    *ret = dec(meminf, &in, digestf, d);
+    return (double)(clock() - t0) / CLOCKS_PER_SEC;
+}
+
+/*
+    compare(paths, n)
+    Decompresses each .dbc with the fast decoder and with the reference
+    (bit-at-a-time) decoder, checks that both produce the same bytes and the
+    same return code, and prints the throughput of each.  Returns the number
+    of files that differ or could not be read.
+ */
+static int compare(char **paths, int n)
+{
+    int i, bad = 0;
+    double tfast = 0, tref = 0;
+    uint64_t total = 0;
+
+    for (i = 0; i < n; i++) {
+        FILE *f = fopen(paths[i], "rb");
+        unsigned char *data = NULL;
+        size_t len = 0, cap = 0, got;
+        if (!f) {
+            fprintf(stderr, "%s: cannot open\n", paths[i]);
+            bad++;
+            continue;
+        }
+        do {
+            if (len == cap) {
+                unsigned char *p = realloc(data, cap = cap ? 2 * cap : 1 << 20);
+                if (!p) break;
+                data = p;
+            }
+            got = fread(data + len, 1, cap - len, f);
+            len += got;
+        } while (got > 0);
+        fclose(f);
+        if (len < 12) {
+            fprintf(stderr, "%s: not a .dbc\n", paths[i]);
+            free(data);
+            bad++;
+            continue;
+        }
+
+        /* DCL stream starts after the DBF header and 4 bytes (see dbc2dbf) */
+        size_t start = (size_t)(data[8] + (data[9] << 8)) + 4;
+        if (start > len) start = len;
+
+        struct digest df, dr;
+        int rf, rr;
+        double sf = timed(blast, data, len, start, &df, &rf);
+        double sr = timed(blast_reference, data, len, start, &dr, &rr);
+        int same = rf == rr && df.bytes == dr.bytes && df.hash == dr.hash;
+
+        printf("%s: %s  %llu bytes  fast %.1f MB/s  reference %.1f MB/s  (x%.2f)%s\n",
+               paths[i], same ? "ok" : "DIFFERENT",
+               (unsigned long long)df.bytes,
+               sf > 0 ? df.bytes / sf / 1e6 : 0.0,
+               sr > 0 ? dr.bytes / sr / 1e6 : 0.0,
+               sf > 0 ? sr / sf : 0.0,
+               rf ? " (blast error)" : "");
+        if (!same) {
+            printf("    fast: ret %d, %llu bytes; reference: ret %d, %llu bytes\n",
+                   rf, (unsigned long long)df.bytes, rr, (unsigned long long)dr.bytes);
+            bad++;
+        }
+        tfast += sf;
+        tref += sr;
+        total += df.bytes;
+        free(data);
+    }
+    if (n > 1 && tfast > 0 && tref > 0)
+        printf("total: %llu bytes  fast %.1f MB/s  reference %.1f MB/s  (x%.2f)\n",
+               (unsigned long long)total, total / tfast / 1e6, total / tref / 1e6, tref / tfast);
+    return bad;
+}
+#endif
+
 /* Print program usage */
 void help(char* prog_name){
     fprintf(stderr, "Syntax error!\n");
     fprintf(stderr, "\tUsage: %s input.dbc output.dbf\n", prog_name);
+#ifdef BLAST_REFERENCE
+    fprintf(stderr, "\t       %s --compare file.dbc [...]\n", prog_name);
+#endif
 }
 
 /* The command line version of the dbc2dbf converter */
@@ -100,6 +238,12 @@ int main(int argc, char **argv)
     int ret;
     FILE* input, *output;
 
+#ifdef BLAST_REFERENCE
+    /* check the fast decoder against the reference one on a DBC corpus */
+    if(argc >= 3 && strcmp(argv[1], "--compare") == 0)
+        return compare(argv + 2, argc - 2) != 0;
+#endif
+
     if(argc == 3){
         input = fopen(argv[1], "rb");
         output = fopen(argv[2], "wb");
@@ -24,13 +24,29 @@
  * 1.1  16 Feb 2003     - Fixed distance check for > 4 GB uncompressed data
  * 1.2  24 Oct 2012     - Add note about using binary mode in stdio
  *                      - Fix comparisons of differently signed integers
+ * 1.2-dbf              - Fixed Huffman tables precomputed in blastfix.h (read
+ *                        only, no first-call setup), so blast() is reentrant
+ *                      - Add blast_ctx for reusable heap-allocated state
+ *                      - Fast decoder: 64-bit bit buffer, table lookup of the
+ *                        Huffman codes (8-bit root + sub-tables up to 13 bits)
+ *                        and wide match copies; the original bit-at-a-time
+ *                        decoder is kept as blast_reference() (-DBLAST_REFERENCE)
  */
 
+
 #include <setjmp.h>             /* for setjmp(), longjmp(), and jmp_buf */
+#include <stdint.h>             /* for uint64_t */
+#include <stdlib.h>             /* for malloc(), free() */
+#include <string.h>             /* for memcpy(), memset() */
 #include "blast.h"              /* prototype for blast() */
+#ifdef MAKEFIXED
+#  include <stdio.h>            /* for printf() */
+#endif
 
 #define MAXBITS 13              /* maximum code length */
 #define MAXWIN 4096             /* maximum window size */
+#define ROOTBITS 8              /* bits indexed by the root lookup tables */
+#define SUBBITS (MAXBITS - ROOTBITS)    /* bits indexed by sub-tables */
 
 /* input and output state */
 struct state {
@@ -39,7 +55,7 @@ struct state {
     void *inhow;                /* opaque information passed to infun() */
     unsigned char *in;          /* next input location */
     unsigned left;              /* available input at in */
-    int bitbuf;                 /* bit buffer */
+    uint64_t bitbuf;            /* bit buffer */
     int bitcnt;                 /* number of bits in bit buffer */
 
     /* input limit error return state for bits() and decode() */
@@ -53,6 +69,484 @@ struct state {
     unsigned char out[MAXWIN];  /* output buffer and sliding window */
 };
 
+
+/*
+ * Lookup table entry: for a code of bits bits, val is the symbol; for a link
+ * (link != 0, bits == ROOTBITS), val is the offset of the sub-table.  bits ==
+ * 0 marks an invalid code.
+ */
+typedef struct {
+    unsigned short val;         /* symbol, or sub-table offset for a link */
+    unsigned char bits;         /* code length (0 = invalid) */
+    unsigned char link;         /* true if val is a sub-table offset */
+} code;
+
+
+#ifdef MAKEFIXED
+static int construct(short *count, short *sym, const unsigned char *rep, int n)
+{
+    int symbol;         /* current symbol when stepping through length[] */
+    int len;            /* current length when stepping through h->count[] */
+    int left;           /* number of possible codes left of current length */
+    short offs[MAXBITS+1];      /* offsets in symbol table for each length */
+    short length[256];  /* code lengths */
+
+    /* convert compact repeat counts into symbol bit length list */
+    symbol = 0;
+    do {
+        len = *rep++;
+        left = (len >> 4) + 1;
+        len &= 15;
+        do {
+            length[symbol++] = len;
+        } while (--left);
+    } while (--n);
+    n = symbol;
+
+    /* count number of codes of each length */
+    for (len = 0; len <= MAXBITS; len++)
+        count[len] = 0;
+    for (symbol = 0; symbol < n; symbol++)
+        (count[length[symbol]])++;      /* assumes lengths are within bounds */
+    if (count[0] == n)                  /* no codes! */
+        return 0;                       /* complete, but decode() will fail */
+
+    /* check for an over-subscribed or incomplete set of lengths */
+    left = 1;                           /* one possible code of zero length */
+    for (len = 1; len <= MAXBITS; len++) {
+        left <<= 1;                     /* one more bit, double codes left */
+        left -= count[len];             /* deduct count from possible codes */
+        if (left < 0) return left;      /* over-subscribed--return negative */
+    }                                   /* left > 0 means incomplete */
+
+    /* generate offsets into symbol table for each length for sorting */
+    offs[1] = 0;
+    for (len = 1; len < MAXBITS; len++)
+        offs[len + 1] = offs[len] + count[len];
+
+    /*
+     * put symbols in table sorted by length, by symbol order within each
+     * length
+     */
+    for (symbol = 0; symbol < n; symbol++)
+        if (length[symbol] != 0)
+            sym[offs[length[symbol]]++] = symbol;
+
+    /* return zero for complete set, positive for incomplete set */
+    return left;
+}
+
+/* print one table as a C initializer */
+static void putshorts(FILE *out, const char *name, const short *v, int n)
+{
+    int i;
+
+    fprintf(out, "static const short %s[%d] = {", name, n);
+    for (i = 0; i < n; i++)
+        fprintf(out, "%s%s%d", i ? "," : "", i % 16 ? " " : "\n    ", v[i]);
+    fprintf(out, "};\n");
+}
+
+/*
+ * Build the lookup tables for the canonical code in count[] and sym[].  The
+ * tables are indexed directly by the next bits of the stream (least
+ * significant bit first), so the code bits are inverted and reversed here
+ * once instead of one at a time while decoding.  root[] has 1 << ROOTBITS
+ * entries; codes longer than ROOTBITS put a link in root[] to a sub-table of
+ * 1 << SUBBITS entries in sub[], indexed by the following bits.  Entries not
+ * covered by any code keep bits == 0 (invalid).  Returns the number of sub[]
+ * entries used.
+ */
+static int lookup(const short *count, const short *sym, code *root, code *sub)
+{
+    int len, k, index, nsub;
+    unsigned first, c, rev, i;
+    short link[1 << ROOTBITS];          /* sub-table of each root entry */
+
+    for (i = 0; i < (1U << ROOTBITS); i++) {
+        root[i].val = 0;
+        root[i].bits = 0;
+        root[i].link = 0;
+        link[i] = -1;
+    }
+    nsub = 0;
+    first = 0;
+    index = 0;
+    for (len = 1; len <= MAXBITS; len++) {
+        for (k = 0; k < count[len]; k++) {
+            c = first + k;
+            rev = 0;                    /* stream order, inverted */
+            for (i = 0; i < (unsigned)len; i++)
+                rev |= (((c >> (len - 1 - i)) & 1) ^ 1) << i;
+            if (len <= ROOTBITS) {
+                for (i = rev; i < (1U << ROOTBITS); i += 1U << len) {
+                    root[i].val = sym[index + k];
+                    root[i].bits = len;
+                }
+            }
+            else {
+                unsigned r = rev & ((1U << ROOTBITS) - 1);
+                if (link[r] < 0) {
+                    link[r] = nsub;
+                    for (i = 0; i < (1U << SUBBITS); i++) {
+                        sub[nsub + i].val = 0;
+                        sub[nsub + i].bits = 0;
+                        sub[nsub + i].link = 0;
+                    }
+                    nsub += 1 << SUBBITS;
+                    root[r].val = link[r];
+                    root[r].bits = ROOTBITS;
+                    root[r].link = 1;
+                }
+                for (i = rev >> ROOTBITS; i < (1U << SUBBITS);
+                     i += 1U << (len - ROOTBITS)) {
+                    sub[link[r] + i].val = sym[index + k];
+                    sub[link[r] + i].bits = len;
+                }
+            }
+        }
+        index += count[len];
+        first = (first + count[len]) << 1;
+    }
+    return nsub;
+}
+
+/* print a lookup table as a C initializer */
+static void putcodes(FILE *out, const char *name, const code *v, int n)
+{
+    int i;
+
+    fprintf(out, "static const code %s[%d] = {", name, n ? n : 1);
+    for (i = 0; i < n; i++)
+        fprintf(out, "%s%s{%d,%d,%d}", i ? "," : "", i % 8 ? " " : "\n    ",
+                v[i].val, v[i].bits, v[i].link);
+    if (n == 0)
+        fprintf(out, "{0,0,0}");
+    fprintf(out, "};\n");
+}
+
+/*
+ * Write blastfix.h, the fixed decoding tables that decomp() uses.  The code
+ * lengths below are the ones defined by the format.  Build with -DMAKEFIXED
+ * and call makefixed() to regenerate the header:
+ *
+ *     cc -DMAKEFIXED -o makefixed blast.c && ./makefixed > blastfix.h
+ */
+static short litcnt[MAXBITS+1], litsym[256];    /* litcode memory */
+static short lencnt[MAXBITS+1], lensym[16];     /* lencode memory */
+static short distcnt[MAXBITS+1], distsym[64];   /* distcode memory */
+static code litroot[1 << ROOTBITS], litsub[256 << SUBBITS];  /* lookup tables */
+static code lenroot[1 << ROOTBITS], distroot[1 << ROOTBITS];
+
+void makefixed(void)
+{
+        /* bit lengths of literal codes */
+    static const unsigned char litlen[] = {
+        11, 124, 8, 7, 28, 7, 188, 13, 76, 4, 10, 8, 12, 10, 12, 10, 8, 23, 8,
+        9, 7, 6, 7, 8, 7, 6, 55, 8, 23, 24, 12, 11, 7, 9, 11, 12, 6, 7, 22, 5,
+        7, 24, 6, 11, 9, 6, 7, 22, 7, 11, 38, 7, 9, 8, 25, 11, 8, 11, 9, 12,
+        8, 12, 5, 38, 5, 38, 5, 11, 7, 5, 6, 21, 6, 10, 53, 8, 7, 24, 10, 27,
+        44, 253, 253, 253, 252, 252, 252, 13, 12, 45, 12, 45, 12, 61, 12, 45,
+        44, 173};
+        /* bit lengths of length codes 0..15 */
+    static const unsigned char lenlen[] = {2, 35, 36, 53, 38, 23};
+        /* bit lengths of distance codes 0..63 */
+    static const unsigned char distlen[] = {2, 20, 53, 230, 247, 151, 248};
+
+    static code none[1 << SUBBITS];     /* sub-tables of the short codes */
+    int nsub;
+
+    if (construct(litcnt, litsym, litlen, sizeof(litlen)) ||
+        construct(lencnt, lensym, lenlen, sizeof(lenlen)) ||
+        construct(distcnt, distsym, distlen, sizeof(distlen)))
+        fprintf(stderr, "makefixed: incomplete code (invalid lookup entries)\n");
+
+    printf("/* blastfix.h -- fixed Huffman decoding tables for blast.c\n");
+    printf(" * Generated automatically by makefixed() in blast.c.  Do not edit.\n");
+    printf(" */\n\n");
+
+    /* lookup tables for the fast decoder */
+    nsub = lookup(litcnt, litsym, litroot, litsub);
+    putcodes(stdout, "litroot", litroot, 1 << ROOTBITS);
+    putcodes(stdout, "litsub", litsub, nsub);
+    if (lookup(lencnt, lensym, lenroot, none) ||
+        lookup(distcnt, distsym, distroot, none))
+        fprintf(stderr, "makefixed: length/distance code longer than ROOTBITS\n");
+    putcodes(stdout, "lenroot", lenroot, 1 << ROOTBITS);
+    putcodes(stdout, "distroot", distroot, 1 << ROOTBITS);
+
+    /* canonical tables for the reference decoder */
+    printf("\n#ifdef BLAST_REFERENCE\n");
+    putshorts(stdout, "litcnt", litcnt, MAXBITS+1);
+    putshorts(stdout, "litsym", litsym, 256);
+    putshorts(stdout, "lencnt", lencnt, MAXBITS+1);
+    putshorts(stdout, "lensym", lensym, 16);
+    putshorts(stdout, "distcnt", distcnt, MAXBITS+1);
+    putshorts(stdout, "distsym", distsym, 64);
+    printf("#endif\n");
+}
+
+int main(void)
+{
+    makefixed();
+    return 0;
+}
+#else /* !MAKEFIXED */
+#  include "blastfix.h"         /* litroot[], litsub[], lenroot[], ... */
+#endif
+
+
+/*
+ * Fast input.  The bit buffer is 64 bits wide and, inside decomp(), lives in
+ * the locals hold and have (saved to the state with the output position next
+ * before more() can longjmp, so blast() still writes the leftover output).  FILL() tops it
+ * up from the current input buffer eight bytes at a time without calling
+ * infun(); more() appends one byte, calling infun() only when the bits are
+ * actually needed -- so infun() is called exactly when the reference decoder
+ * would call it.  Bits above have in hold are always zero.
+ */
+static void more(struct state *s)
+{
+    if (s->left == 0) {
+        s->left = s->infun(s->inhow, &(s->in));
+        if (s->left == 0) longjmp(s->env, 1);           /* out of input */
+    }
+    s->bitbuf |= (uint64_t)(*(s->in)++) << s->bitcnt;
+    s->left--;
+    s->bitcnt += 8;
+}
+
+/* little-endian 64-bit load */
+static uint64_t load64(const unsigned char *p)
+{
+    return (uint64_t)p[0] | (uint64_t)p[1] << 8 |
+           (uint64_t)p[2] << 16 | (uint64_t)p[3] << 24 |
+           (uint64_t)p[4] << 32 | (uint64_t)p[5] << 40 |
+           (uint64_t)p[6] << 48 | (uint64_t)p[7] << 56;
+}
+
+/* bit buffer macros for decomp() */
+#define LOAD() \
+    do { hold = s->bitbuf; have = s->bitcnt; } while (0)
+#define STORE() \
+    do { s->bitbuf = hold; s->bitcnt = have; s->next = next; } while (0)
+#define FILL() \
+    do { \
+        if (s->left >= 8) { \
+            unsigned n_ = (63 - have) >> 3; \
+            hold |= (load64(s->in) << have) & \
+                    ((((uint64_t)1) << (have + 8 * n_)) - 1); \
+            s->in += n_; \
+            s->left -= n_; \
+            have += 8 * n_; \
+        } \
+    } while (0)
+#define NEEDBITS(n) \
+    do { \
+        while (have < (unsigned)(n)) { STORE(); more(s); LOAD(); } \
+    } while (0)
+#define BITS(n) \
+    ((int)((unsigned)hold & ((1U << (n)) - 1)))
+#define DROPBITS(n) \
+    do { hold >>= (n); have -= (unsigned)(n); } while (0)
+
+/*
+ * Decode a code with the lookup tables root[] and sub[] into the int sym.
+ * The entry is looked up with whatever bits are buffered; since the code is
+ * prefix-free, an entry no longer than have is the right one, and otherwise
+ * one more byte is loaded and the lookup repeated.  sym is -9 for an invalid
+ * code (not possible with the complete fixed codes).
+ */
+#define DECODE(sym, root, sub) \
+    do { \
+        code here_; \
+        while (1) { \
+            here_ = (root)[hold & ((1U << ROOTBITS) - 1)]; \
+            if (here_.link) \
+                here_ = (sub)[here_.val + \
+                              ((hold >> ROOTBITS) & ((1U << SUBBITS) - 1))]; \
+            if (here_.bits && here_.bits <= have) { \
+                DROPBITS(here_.bits); \
+                sym = here_.val; \
+                break; \
+            } \
+            if (have >= MAXBITS) { sym = -9; break; } \
+            STORE(); more(s); LOAD(); \
+        } \
+    } while (0)
+
+/*
+ * Copy len bytes from from[] to to[] (from < to: len may exceed the distance,
+ * and the copy must replicate; from > to: the source is the older part of the
+ * window, ahead of to).  Eight bytes at a time when the distance allows it,
+ * never writing past to + len, since the bytes after it are still history.
+ */
+static void copymatch(unsigned char *to, const unsigned char *from, int len)
+{
+    if (from > to || to - from >= 8) {
+        while (len >= 8) {
+            uint64_t w;
+            memcpy(&w, from, 8);
+            memcpy(to, &w, 8);
+            from += 8;
+            to += 8;
+            len -= 8;
+        }
+    }
+    else if (to - from == 1) {
+        memset(to, from[0], len);
+        return;
+    }
+    while (len--)
+        *to++ = *from++;
+}
+
+/*
+ * Decode PKWare Compression Library stream.
+ *
+ * Format notes:
+ *
+ * - First byte is 0 if literals are uncoded or 1 if they are coded.  Second
+ *   byte is 4, 5, or 6 for the number of extra bits in the distance code.
+ *   This is the base-2 logarithm of the dictionary size minus six.
+ *
+ * - Compressed data is a combination of literals and length/distance pairs
+ *   terminated by an end code.  Literals are either Huffman coded or
+ *   uncoded bytes.  A length/distance pair is a coded length followed by a
+ *   coded distance to represent a string that occurs earlier in the
+ *   uncompressed data that occurs again at the current location.
+ *
+ * - A bit preceding a literal or length/distance pair indicates which comes
+ *   next, 0 for literals, 1 for length/distance.
+ *
+ * - If literals are uncoded, then the next eight bits are the literal, in the
+ *   normal bit order in th stream, i.e. no bit-reversal is needed. Similarly,
+ *   no bit reversal is needed for either the length extra bits or the distance
+ *   extra bits.
+ *
+ * - Literal bytes are simply written to the output.  A length/distance pair is
+ *   an instruction to copy previously uncompressed bytes to the output.  The
+ *   copy is from distance bytes back in the output stream, copying for length
+ *   bytes.
+ *
+ * - Distances pointing before the beginning of the output data are not
+ *   permitted.
+ *
+ * - Overlapped copies, where the length is greater than the distance, are
+ *   allowed and common.  For example, a distance of one and a length of 518
+ *   simply copies the last byte 518 times.  A distance of four and a length of
+ *   twelve copies the last four bytes three times.  A simple forward copy
+ *   ignoring whether the length is greater than the distance or not implements
+ *   this correctly.
+ */
+static int decomp(struct state *s)
+{
+    int lit;            /* true if literals are coded */
+    int dict;           /* log2(dictionary size) - 6 */
+    int symbol;         /* decoded symbol, extra bits for distance */
+    int len;            /* length for copy */
+    unsigned dist;      /* distance for copy */
+    int copy;           /* copy counter */
+    unsigned char *from, *to;   /* copy pointers */
+    uint64_t hold;      /* local bit buffer */
+    unsigned have;      /* bits in hold */
+    unsigned next;      /* local copy of s->next */
+    static const short base[16] = {     /* base for length codes */
+        3, 2, 4, 5, 6, 7, 8, 9, 10, 12, 16, 24, 40, 72, 136, 264};
+    static const char extra[16] = {     /* extra bits for length codes */
+        0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 3, 4, 5, 6, 7, 8};
+
+    LOAD();
+    next = s->next;
+
+    /* read header */
+    NEEDBITS(8);
+    lit = BITS(8);
+    DROPBITS(8);
+    if (lit > 1) return -1;
+    NEEDBITS(8);
+    dict = BITS(8);
+    DROPBITS(8);
+    if (dict < 4 || dict > 6) return -2;
+
+    /* decode literals and length/distance pairs */
+    do {
+        /* a length/distance pair takes at most 1 + 7 + 8 + 8 + 6 = 30 bits */
+        if (have < 30) FILL();
+        NEEDBITS(1);
+        symbol = BITS(1);
+        DROPBITS(1);
+        if (symbol) {
+            /* get length */
+            DECODE(symbol, lenroot, lenroot);
+            if (symbol < 0) { s->next = next; return symbol; }
+            NEEDBITS(extra[symbol]);
+            len = base[symbol] + BITS(extra[symbol]);
+            DROPBITS(extra[symbol]);
+            if (len == 519) break;              /* end code */
+
+            /* get distance */
+            symbol = len == 2 ? 2 : dict;
+            DECODE(copy, distroot, distroot);
+            if (copy < 0) { s->next = next; return copy; }
+            NEEDBITS(symbol);
+            dist = ((unsigned)copy << symbol) + BITS(symbol);
+            DROPBITS(symbol);
+            dist++;
+            if (s->first && dist > next) {
+                s->next = next;
+                return -3;              /* distance too far back */
+            }
+
+            /* copy length bytes from distance bytes back */
+            do {
+                to = s->out + next;
+                from = to - dist;
+                copy = MAXWIN;
+                if (next < dist) {
+                    from += copy;
+                    copy = dist;
+                }
+                copy -= next;
+                if (copy > len) copy = len;
+                len -= copy;
+                next += copy;
+                copymatch(to, from, copy);
+                if (next == MAXWIN) {
+                    if (s->outfun(s->outhow, s->out, next)) return 1;
+                    next = 0;
+                    s->first = 0;
+                }
+            } while (len != 0);
+        }
+        else {
+            /* get literal and write it */
+            if (lit)
+                DECODE(symbol, litroot, litsub);
+            else {
+                NEEDBITS(8);
+                symbol = BITS(8);
+                DROPBITS(8);
+            }
+            if (symbol < 0) { s->next = next; return symbol; }
+            s->out[next++] = symbol;
+            if (next == MAXWIN) {
+                if (s->outfun(s->outhow, s->out, next)) return 1;
+                next = 0;
+                s->first = 0;
+            }
+        }
+    } while (1);
+    STORE();
+    return 0;
+}
+
+#ifdef BLAST_REFERENCE
+/*
+ * Reference decoder: the original bit-at-a-time implementation, used only to
+ * check the fast decoder (see blast_reference() in blast.h).  It keeps fewer
+ * than eight bits in bitbuf.
+ */
 /*
  * Return need bits from the input stream.  This always leaves less than
  * eight bits in the buffer.  bits() works properly for need == 0.
@@ -64,12 +558,12 @@ struct state {
  *   buffer, using shift right, and new bytes are appended to the top of the
  *   bit buffer, using shift left.
  */
-static int bits(struct state *s, int need)
+static int ref_bits(struct state *s, int need)
 {
     int val;            /* bit accumulator */
 
     /* load at least need bits into val */
-    val = s->bitbuf;
+    val = (int)s->bitbuf;
     while (s->bitcnt < need) {
         if (s->left == 0) {
             s->left = s->infun(s->inhow, &(s->in));
@@ -81,7 +575,7 @@ static int bits(struct state *s, int need)
     }
 
     /* drop need bits and update buffer, always zero to seven bits left */
-    s->bitbuf = val >> need;
+    s->bitbuf = (unsigned)val >> need;
     s->bitcnt -= need;
 
     /* return need bits, zeroing the bits above that */
@@ -93,11 +587,11 @@ static int bits(struct state *s, int need)
  * each length, which for a canonical code are stepped through in order.
  * symbol[] are the symbol values in canonical order, where the number of
  * entries is the sum of the counts in count[].  The decoding process can be
- * seen in the function decode() below.
+ * seen in the function ref_decode() below.
  */
 struct huffman {
-    short *count;       /* number of symbols of each length */
-    short *symbol;      /* canonically ordered symbols */
+    const short *count;         /* number of symbols of each length */
+    const short *symbol;        /* canonically ordered symbols */
 };
 
 /*
@@ -121,7 +615,7 @@ struct huffman {
  *   this ordering, the bits pulled during decoding are inverted to apply the
  *   more "natural" ordering starting with all zeros and incrementing.
  */
-static int decode(struct state *s, struct huffman *h)
+static int ref_decode(struct state *s, const struct huffman *h)
 {
     int len;            /* current number of bits in code */
     int code;           /* len bits being decoded */
@@ -130,9 +624,9 @@ static int decode(struct state *s, struct huffman *h)
     int index;          /* index of first code of length len in symbol table */
     int bitbuf;         /* bits from stream */
     int left;           /* bits left in next or left to process */
-    short *next;        /* next number of codes */
+    const short *next;  /* next number of codes */
 
-    bitbuf = s->bitbuf;
+    bitbuf = (int)s->bitbuf;
     left = s->bitcnt;
     code = first = index = 0;
     len = 1;
@@ -183,98 +677,12 @@ static int decode(struct state *s, struct huffman *h)
  * it is possible for decode() using that table to return an error for received
  * codes past the end of the incomplete lengths.
  */
-static int construct(struct huffman *h, const unsigned char *rep, int n)
-{
-    int symbol;         /* current symbol when stepping through length[] */
-    int len;            /* current length when stepping through h->count[] */
-    int left;           /* number of possible codes left of current length */
-    short offs[MAXBITS+1];      /* offsets in symbol table for each length */
-    short length[256];  /* code lengths */
 
-    /* convert compact repeat counts into symbol bit length list */
-    symbol = 0;
-    do {
-        len = *rep++;
-        left = (len >> 4) + 1;
-        len &= 15;
-        do {
-            length[symbol++] = len;
-        } while (--left);
-    } while (--n);
-    n = symbol;
+static const struct huffman litcode = {litcnt, litsym};    /* literal code */
+static const struct huffman lencode = {lencnt, lensym};    /* length code */
+static const struct huffman distcode = {distcnt, distsym}; /* distance code */
 
-    /* count number of codes of each length */
-    for (len = 0; len <= MAXBITS; len++)
-        h->count[len] = 0;
-    for (symbol = 0; symbol < n; symbol++)
-        (h->count[length[symbol]])++;   /* assumes lengths are within bounds */
-    if (h->count[0] == n)               /* no codes! */
-        return 0;                       /* complete, but decode() will fail */
-
-    /* check for an over-subscribed or incomplete set of lengths */
-    left = 1;                           /* one possible code of zero length */
-    for (len = 1; len <= MAXBITS; len++) {
-        left <<= 1;                     /* one more bit, double codes left */
-        left -= h->count[len];          /* deduct count from possible codes */
-        if (left < 0) return left;      /* over-subscribed--return negative */
-    }                                   /* left > 0 means incomplete */
-
-    /* generate offsets into symbol table for each length for sorting */
-    offs[1] = 0;
-    for (len = 1; len < MAXBITS; len++)
-        offs[len + 1] = offs[len] + h->count[len];
-
-    /*
-     * put symbols in table sorted by length, by symbol order within each
-     * length
-     */
-    for (symbol = 0; symbol < n; symbol++)
-        if (length[symbol] != 0)
-            h->symbol[offs[length[symbol]]++] = symbol;
-
-    /* return zero for complete set, positive for incomplete set */
-    return left;
-}
-
-/*
- * Decode PKWare Compression Library stream.
- *
- * Format notes:
- *
- * - First byte is 0 if literals are uncoded or 1 if they are coded.  Second
- *   byte is 4, 5, or 6 for the number of extra bits in the distance code.
- *   This is the base-2 logarithm of the dictionary size minus six.
- *
- * - Compressed data is a combination of literals and length/distance pairs
- *   terminated by an end code.  Literals are either Huffman coded or
- *   uncoded bytes.  A length/distance pair is a coded length followed by a
- *   coded distance to represent a string that occurs earlier in the
- *   uncompressed data that occurs again at the current location.
- *
- * - A bit preceding a literal or length/distance pair indicates which comes
- *   next, 0 for literals, 1 for length/distance.
- *
- * - If literals are uncoded, then the next eight bits are the literal, in the
- *   normal bit order in th stream, i.e. no bit-reversal is needed. Similarly,
- *   no bit reversal is needed for either the length extra bits or the distance
- *   extra bits.
- *
- * - Literal bytes are simply written to the output.  A length/distance pair is
- *   an instruction to copy previously uncompressed bytes to the output.  The
- *   copy is from distance bytes back in the output stream, copying for length
- *   bytes.
- *
- * - Distances pointing before the beginning of the output data are not
- *   permitted.
- *
- * - Overlapped copies, where the length is greater than the distance, are
- *   allowed and common.  For example, a distance of one and a length of 518
- *   simply copies the last byte 518 times.  A distance of four and a length of
- *   twelve copies the last four bytes three times.  A simple forward copy
- *   ignoring whether the length is greater than the distance or not implements
- *   this correctly.
- */
-static int decomp(struct state *s)
+static int ref_decomp(struct state *s)
 {
     int lit;            /* true if literals are coded */
     int dict;           /* log2(dictionary size) - 6 */
@@ -283,56 +691,29 @@ static int decomp(struct state *s)
     unsigned dist;      /* distance for copy */
     int copy;           /* copy counter */
     unsigned char *from, *to;   /* copy pointers */
-    static int virgin = 1;                              /* build tables once */
-    static short litcnt[MAXBITS+1], litsym[256];        /* litcode memory */
-    static short lencnt[MAXBITS+1], lensym[16];         /* lencode memory */
-    static short distcnt[MAXBITS+1], distsym[64];       /* distcode memory */
-    static struct huffman litcode = {litcnt, litsym};   /* length code */
-    static struct huffman lencode = {lencnt, lensym};   /* length code */
-    static struct huffman distcode = {distcnt, distsym};/* distance code */
-        /* bit lengths of literal codes */
-    static const unsigned char litlen[] = {
-        11, 124, 8, 7, 28, 7, 188, 13, 76, 4, 10, 8, 12, 10, 12, 10, 8, 23, 8,
-        9, 7, 6, 7, 8, 7, 6, 55, 8, 23, 24, 12, 11, 7, 9, 11, 12, 6, 7, 22, 5,
-        7, 24, 6, 11, 9, 6, 7, 22, 7, 11, 38, 7, 9, 8, 25, 11, 8, 11, 9, 12,
-        8, 12, 5, 38, 5, 38, 5, 11, 7, 5, 6, 21, 6, 10, 53, 8, 7, 24, 10, 27,
-        44, 253, 253, 253, 252, 252, 252, 13, 12, 45, 12, 45, 12, 61, 12, 45,
-        44, 173};
-        /* bit lengths of length codes 0..15 */
-    static const unsigned char lenlen[] = {2, 35, 36, 53, 38, 23};
-        /* bit lengths of distance codes 0..63 */
-    static const unsigned char distlen[] = {2, 20, 53, 230, 247, 151, 248};
     static const short base[16] = {     /* base for length codes */
         3, 2, 4, 5, 6, 7, 8, 9, 10, 12, 16, 24, 40, 72, 136, 264};
     static const char extra[16] = {     /* extra bits for length codes */
         0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 3, 4, 5, 6, 7, 8};
 
-    /* set up decoding tables (once--might not be thread-safe) */
-    if (virgin) {
-        construct(&litcode, litlen, sizeof(litlen));
-        construct(&lencode, lenlen, sizeof(lenlen));
-        construct(&distcode, distlen, sizeof(distlen));
-        virgin = 0;
-    }
-
     /* read header */
-    lit = bits(s, 8);
+    lit = ref_bits(s, 8);
     if (lit > 1) return -1;
-    dict = bits(s, 8);
+    dict = ref_bits(s, 8);
     if (dict < 4 || dict > 6) return -2;
 
     /* decode literals and length/distance pairs */
     do {
-        if (bits(s, 1)) {
+        if (ref_bits(s, 1)) {
             /* get length */
-            symbol = decode(s, &lencode);
-            len = base[symbol] + bits(s, extra[symbol]);
+            symbol = ref_decode(s, &lencode);
+            len = base[symbol] + ref_bits(s, extra[symbol]);
             if (len == 519) break;              /* end code */
 
             /* get distance */
             symbol = len == 2 ? 2 : dict;
-            dist = decode(s, &distcode) << symbol;
-            dist += bits(s, symbol);
+            dist = ref_decode(s, &distcode) << symbol;
+            dist += ref_bits(s, symbol);
             dist++;
             if (s->first && dist > s->next)
                 return -3;              /* distance too far back */
@@ -362,7 +743,7 @@ static int decomp(struct state *s)
         }
         else {
             /* get literal and write it */
-            symbol = lit ? decode(s, &litcode) : bits(s, 8);
+            symbol = lit ? ref_decode(s, &litcode) : ref_bits(s, 8);
             s->out[s->next++] = symbol;
             if (s->next == MAXWIN) {
                 if (s->outfun(s->outhow, s->out, s->next)) return 1;
@@ -374,33 +755,77 @@ static int decomp(struct state *s)
     return 0;
 }
 
-/* See comments in blast.h */
-int blast(blast_in infun, void *inhow, blast_out outfun, void *outhow)
+#endif /* BLAST_REFERENCE */
+
+/* run a decompression with the state s (tables are shared and read only) */
+static int run(struct state *s, int (*dec)(struct state *),
+               blast_in infun, void *inhow, blast_out outfun, void *outhow)
 {
-    struct state s;             /* input/output state */
     int err;                    /* return value */
 
     /* initialize input state */
-    s.infun = infun;
-    s.inhow = inhow;
-    s.left = 0;
-    s.bitbuf = 0;
-    s.bitcnt = 0;
+    s->infun = infun;
+    s->inhow = inhow;
+    s->left = 0;
+    s->bitbuf = 0;
+    s->bitcnt = 0;
 
     /* initialize output state */
-    s.outfun = outfun;
-    s.outhow = outhow;
-    s.next = 0;
-    s.first = 1;
+    s->outfun = outfun;
+    s->outhow = outhow;
+    s->next = 0;
+    s->first = 1;
 
     /* return if bits() or decode() tries to read past available input */
-    if (setjmp(s.env) != 0)             /* if came back here via longjmp(), */
+    if (setjmp(s->env) != 0)            /* if came back here via longjmp(), */
         err = 2;                        /*  then skip decomp(), return error */
     else
-        err = decomp(&s);               /* decompress */
+        err = dec(s);                   /* decompress */
 
     /* write any leftover output and update the error code if needed */
-    if (err != 1 && s.next && s.outfun(s.outhow, s.out, s.next) && err == 0)
+    if (err != 1 && s->next && s->outfun(s->outhow, s->out, s->next) && err == 0)
         err = 1;
     return err;
 }
+
+/* See comments in blast.h */
+int blast(blast_in infun, void *inhow, blast_out outfun, void *outhow)
+{
+    struct state s;             /* input/output state */
+
+    return run(&s, decomp, infun, inhow, outfun, outhow);
+}
+
+/* decompression context: the state, reused across calls */
+struct blast_ctx {
+    struct state s;
+};
+
+/* See comments in blast.h */
+blast_ctx *blast_ctx_new(void)
+{
+    return malloc(sizeof(blast_ctx));
+}
+
+/* See comments in blast.h */
+void blast_ctx_free(blast_ctx *ctx)
+{
+    free(ctx);
+}
+
+/* See comments in blast.h */
+int blast_ctx_run(blast_ctx *ctx, blast_in infun, void *inhow,
+                  blast_out outfun, void *outhow)
+{
+    return run(&ctx->s, decomp, infun, inhow, outfun, outhow);
+}
+
+#ifdef BLAST_REFERENCE
+/* See comments in blast.h */
+int blast_reference(blast_in infun, void *inhow, blast_out outfun, void *outhow)
+{
+    struct state s;             /* input/output state */
+
+    return run(&s, ref_decomp, infun, inhow, outfun, outhow);
+}
+#endif
@@ -73,3 +73,28 @@ int blast(blast_in infun, void *inhow, blast_out outfun, void *outhow);
  * At the bottom of blast.c is an example program that uses blast() that can be
  * compiled to produce a command-line decompression filter by defining TEST.
  */
+
+
+typedef struct blast_ctx blast_ctx;
+blast_ctx *blast_ctx_new(void);
+void blast_ctx_free(blast_ctx *ctx);
+int blast_ctx_run(blast_ctx *ctx, blast_in infun, void *inhow,
+                  blast_out outfun, void *outhow);
+/* Same as blast(), but with the decompression state (including the 4K sliding
+ * window) in a heap-allocated context that can be reused for many streams.
+ * blast_ctx_new() returns NULL if out of memory.
+ *
+ * blast() and blast_ctx_run() are reentrant: the fixed Huffman tables are
+ * static const data (blastfix.h), so any number of threads may decompress at
+ * once, each with its own context (or its own call to blast()).  A context
+ * must not be used by two threads at the same time.
+ */
+
+
+#ifdef BLAST_REFERENCE
+int blast_reference(blast_in infun, void *inhow, blast_out outfun, void *outhow);
+/* The original bit-at-a-time decoder, with the same interface and return
+ * codes as blast().  It is only compiled with -DBLAST_REFERENCE and is used by
+ * "dbc2dbf --compare" to check the table-driven decoder and measure speed.
+ */
+#endif
@@ -0,0 +1,193 @@
+/* blastfix.h -- fixed Huffman decoding tables for blast.c
+ * Generated automatically by makefixed() in blast.c.  Do not edit.
+ */
+
+static const code litroot[256] = {
+    {416,8,1}, {73,6,0}, {41,7,0}, {110,5,0}, {107,7,0}, {116,5,0}, {99,6,0}, {97,5,0},
+    {118,8,0}, {49,6,0}, {104,6,0}, {105,5,0}, {55,7,0}, {114,5,0}, {82,6,0}, {32,4,0},
+    {160,8,1}, {67,6,0}, {112,6,0}, {108,5,0}, {70,7,0}, {115,5,0}, {84,6,0}, {69,5,0},
+    {54,8,0}, {117,5,0}, {102,6,0}, {101,5,0}, {50,7,0}, {111,5,0}, {78,6,0}, {32,4,0},
+    {288,8,1}, {68,6,0}, {13,7,0}, {110,5,0}, {80,7,0}, {116,5,0}, {98,6,0}, {97,5,0},
+    {72,8,0}, {45,6,0}, {103,6,0}, {105,5,0}, {52,7,0}, {114,5,0}, {79,6,0}, {32,4,0},
+    {32,8,1}, {65,6,0}, {109,6,0}, {108,5,0}, {61,7,0}, {115,5,0}, {83,6,0}, {69,5,0},
+    {34,8,0}, {117,5,0}, {100,6,0}, {101,5,0}, {46,7,0}, {111,5,0}, {76,6,0}, {32,4,0},
+    {352,8,1}, {73,6,0}, {40,7,0}, {110,5,0}, {85,7,0}, {116,5,0}, {99,6,0}, {97,5,0},
+    {91,8,0}, {49,6,0}, {104,6,0}, {105,5,0}, {53,7,0}, {114,5,0}, {82,6,0}, {32,4,0},
+    {96,8,1}, {67,6,0}, {112,6,0}, {108,5,0}, {66,7,0}, {115,5,0}, {84,6,0}, {69,5,0},
+    {42,8,0}, {117,5,0}, {102,6,0}, {101,5,0}, {48,7,0}, {111,5,0}, {78,6,0}, {32,4,0},
+    {224,8,1}, {68,6,0}, {10,7,0}, {110,5,0}, {77,7,0}, {116,5,0}, {98,6,0}, {97,5,0},
+    {58,8,0}, {45,6,0}, {103,6,0}, {105,5,0}, {51,7,0}, {114,5,0}, {79,6,0}, {32,4,0},
+    {121,8,0}, {65,6,0}, {109,6,0}, {108,5,0}, {56,7,0}, {115,5,0}, {83,6,0}, {69,5,0},
+    {119,7,0}, {117,5,0}, {100,6,0}, {101,5,0}, {44,7,0}, {111,5,0}, {76,6,0}, {32,4,0},
+    {384,8,1}, {73,6,0}, {41,7,0}, {110,5,0}, {107,7,0}, {116,5,0}, {99,6,0}, {97,5,0},
+    {95,8,0}, {49,6,0}, {104,6,0}, {105,5,0}, {55,7,0}, {114,5,0}, {82,6,0}, {32,4,0},
+    {128,8,1}, {67,6,0}, {112,6,0}, {108,5,0}, {70,7,0}, {115,5,0}, {84,6,0}, {69,5,0},
+    {47,8,0}, {117,5,0}, {102,6,0}, {101,5,0}, {50,7,0}, {111,5,0}, {78,6,0}, {32,4,0},
+    {256,8,1}, {68,6,0}, {13,7,0}, {110,5,0}, {80,7,0}, {116,5,0}, {98,6,0}, {97,5,0},
+    {71,8,0}, {45,6,0}, {103,6,0}, {105,5,0}, {52,7,0}, {114,5,0}, {79,6,0}, {32,4,0},
+    {0,8,1}, {65,6,0}, {109,6,0}, {108,5,0}, {61,7,0}, {115,5,0}, {83,6,0}, {69,5,0},
+    {9,8,0}, {117,5,0}, {100,6,0}, {101,5,0}, {46,7,0}, {111,5,0}, {76,6,0}, {32,4,0},
+    {320,8,1}, {73,6,0}, {40,7,0}, {110,5,0}, {85,7,0}, {116,5,0}, {99,6,0}, {97,5,0},
+    {87,8,0}, {49,6,0}, {104,6,0}, {105,5,0}, {53,7,0}, {114,5,0}, {82,6,0}, {32,4,0},
+    {64,8,1}, {67,6,0}, {112,6,0}, {108,5,0}, {66,7,0}, {115,5,0}, {84,6,0}, {69,5,0},
+    {39,8,0}, {117,5,0}, {102,6,0}, {101,5,0}, {48,7,0}, {111,5,0}, {78,6,0}, {32,4,0},
+    {192,8,1}, {68,6,0}, {10,7,0}, {110,5,0}, {77,7,0}, {116,5,0}, {98,6,0}, {97,5,0},
+    {57,8,0}, {45,6,0}, {103,6,0}, {105,5,0}, {51,7,0}, {114,5,0}, {79,6,0}, {32,4,0},
+    {120,8,0}, {65,6,0}, {109,6,0}, {108,5,0}, {56,7,0}, {115,5,0}, {83,6,0}, {69,5,0},
+    {119,7,0}, {117,5,0}, {100,6,0}, {101,5,0}, {44,7,0}, {111,5,0}, {76,6,0}, {32,4,0}};
+static const code litsub[448] = {
+    {62,9,0}, {43,9,0}, {62,9,0}, {43,9,0}, {62,9,0}, {43,9,0}, {62,9,0}, {43,9,0},
+    {62,9,0}, {43,9,0}, {62,9,0}, {43,9,0}, {62,9,0}, {43,9,0}, {62,9,0}, {43,9,0},
+    {62,9,0}, {43,9,0}, {62,9,0}, {43,9,0}, {62,9,0}, {43,9,0}, {62,9,0}, {43,9,0},
+    {62,9,0}, {43,9,0}, {62,9,0}, {43,9,0}, {62,9,0}, {43,9,0}, {62,9,0}, {43,9,0},
+    {86,9,0}, {75,9,0}, {86,9,0}, {75,9,0}, {86,9,0}, {75,9,0}, {86,9,0}, {75,9,0},
+    {86,9,0}, {75,9,0}, {86,9,0}, {75,9,0}, {86,9,0}, {75,9,0}, {86,9,0}, {75,9,0},
+    {86,9,0}, {75,9,0}, {86,9,0}, {75,9,0}, {86,9,0}, {75,9,0}, {86,9,0}, {75,9,0},
+    {86,9,0}, {75,9,0}, {86,9,0}, {75,9,0}, {86,9,0}, {75,9,0}, {86,9,0}, {75,9,0},
+    {89,9,0}, {88,9,0}, {89,9,0}, {88,9,0}, {89,9,0}, {88,9,0}, {89,9,0}, {88,9,0},
+    {89,9,0}, {88,9,0}, {89,9,0}, {88,9,0}, {89,9,0}, {88,9,0}, {89,9,0}, {88,9,0},
+    {89,9,0}, {88,9,0}, {89,9,0}, {88,9,0}, {89,9,0}, {88,9,0}, {89,9,0}, {88,9,0},
+    {89,9,0}, {88,9,0}, {89,9,0}, {88,9,0}, {89,9,0}, {88,9,0}, {89,9,0}, {88,9,0},
+    {36,10,0}, {93,9,0}, {33,10,0}, {93,9,0}, {36,10,0}, {93,9,0}, {33,10,0}, {93,9,0},
+    {36,10,0}, {93,9,0}, {33,10,0}, {93,9,0}, {36,10,0}, {93,9,0}, {33,10,0}, {93,9,0},
+    {36,10,0}, {93,9,0}, {33,10,0}, {93,9,0}, {36,10,0}, {93,9,0}, {33,10,0}, {93,9,0},
+    {36,10,0}, {93,9,0}, {33,10,0}, {93,9,0}, {36,10,0}, {93,9,0}, {33,10,0}, {93,9,0},
+    {60,11,0}, {113,10,0}, {122,10,0}, {38,10,0}, {0,11,0}, {113,10,0}, {122,10,0}, {38,10,0},
+    {60,11,0}, {113,10,0}, {122,10,0}, {38,10,0}, {0,11,0}, {113,10,0}, {122,10,0}, {38,10,0},
+    {60,11,0}, {113,10,0}, {122,10,0}, {38,10,0}, {0,11,0}, {113,10,0}, {122,10,0}, {38,10,0},
+    {60,11,0}, {113,10,0}, {122,10,0}, {38,10,0}, {0,11,0}, {113,10,0}, {122,10,0}, {38,10,0},
+    {124,11,0}, {90,11,0}, {106,11,0}, {74,11,0}, {123,11,0}, {81,11,0}, {92,11,0}, {63,11,0},
+    {124,11,0}, {90,11,0}, {106,11,0}, {74,11,0}, {123,11,0}, {81,11,0}, {92,11,0}, {63,11,0},
+    {124,11,0}, {90,11,0}, {106,11,0}, {74,11,0}, {123,11,0}, {81,11,0}, {92,11,0}, {63,11,0},
+    {124,11,0}, {90,11,0}, {106,11,0}, {74,11,0}, {123,11,0}, {81,11,0}, {92,11,0}, {63,11,0},
+    {19,12,0}, {8,12,0}, {15,12,0}, {4,12,0}, {17,12,0}, {6,12,0}, {12,12,0}, {2,12,0},
+    {18,12,0}, {7,12,0}, {14,12,0}, {3,12,0}, {16,12,0}, {5,12,0}, {11,12,0}, {1,12,0},
+    {19,12,0}, {8,12,0}, {15,12,0}, {4,12,0}, {17,12,0}, {6,12,0}, {12,12,0}, {2,12,0},
+    {18,12,0}, {7,12,0}, {14,12,0}, {3,12,0}, {16,12,0}, {5,12,0}, {11,12,0}, {1,12,0},
+    {94,12,0}, {28,12,0}, {35,12,0}, {23,12,0}, {59,12,0}, {25,12,0}, {30,12,0}, {21,12,0},
+    {64,12,0}, {27,12,0}, {31,12,0}, {22,12,0}, {37,12,0}, {24,12,0}, {29,12,0}, {20,12,0},
+    {94,12,0}, {28,12,0}, {35,12,0}, {23,12,0}, {59,12,0}, {25,12,0}, {30,12,0}, {21,12,0},
+    {64,12,0}, {27,12,0}, {31,12,0}, {22,12,0}, {37,12,0}, {24,12,0}, {29,12,0}, {20,12,0},
+    {187,12,0}, {179,12,0}, {183,12,0}, {127,12,0}, {185,12,0}, {177,12,0}, {181,12,0}, {125,12,0},
+    {186,12,0}, {178,12,0}, {182,12,0}, {126,12,0}, {184,12,0}, {176,12,0}, {180,12,0}, {96,12,0},
+    {187,12,0}, {179,12,0}, {183,12,0}, {127,12,0}, {185,12,0}, {177,12,0}, {181,12,0}, {125,12,0},
+    {186,12,0}, {178,12,0}, {182,12,0}, {126,12,0}, {184,12,0}, {176,12,0}, {180,12,0}, {96,12,0},
+    {203,12,0}, {195,12,0}, {199,12,0}, {191,12,0}, {201,12,0}, {193,12,0}, {197,12,0}, {189,12,0},
+    {202,12,0}, {194,12,0}, {198,12,0}, {190,12,0}, {200,12,0}, {192,12,0}, {196,12,0}, {188,12,0},
+    {203,12,0}, {195,12,0}, {199,12,0}, {191,12,0}, {201,12,0}, {193,12,0}, {197,12,0}, {189,12,0},
+    {202,12,0}, {194,12,0}, {198,12,0}, {190,12,0}, {200,12,0}, {192,12,0}, {196,12,0}, {188,12,0},
+    {219,12,0}, {211,12,0}, {215,12,0}, {207,12,0}, {217,12,0}, {209,12,0}, {213,12,0}, {205,12,0},
+    {218,12,0}, {210,12,0}, {214,12,0}, {206,12,0}, {216,12,0}, {208,12,0}, {212,12,0}, {204,12,0},
+    {219,12,0}, {211,12,0}, {215,12,0}, {207,12,0}, {217,12,0}, {209,12,0}, {213,12,0}, {205,12,0},
+    {218,12,0}, {210,12,0}, {214,12,0}, {206,12,0}, {216,12,0}, {208,12,0}, {212,12,0}, {204,12,0},
+    {136,13,0}, {238,12,0}, {128,13,0}, {223,12,0}, {132,13,0}, {229,12,0}, {243,12,0}, {221,12,0},
+    {134,13,0}, {233,12,0}, {244,12,0}, {222,12,0}, {130,13,0}, {225,12,0}, {242,12,0}, {220,12,0},
+    {135,13,0}, {238,12,0}, {26,13,0}, {223,12,0}, {131,13,0}, {229,12,0}, {243,12,0}, {221,12,0},
+    {133,13,0}, {233,12,0}, {244,12,0}, {222,12,0}, {129,13,0}, {225,12,0}, {242,12,0}, {220,12,0},
+    {168,13,0}, {152,13,0}, {160,13,0}, {144,13,0}, {164,13,0}, {148,13,0}, {156,13,0}, {140,13,0},
+    {166,13,0}, {150,13,0}, {158,13,0}, {142,13,0}, {162,13,0}, {146,13,0}, {154,13,0}, {138,13,0},
+    {167,13,0}, {151,13,0}, {159,13,0}, {143,13,0}, {163,13,0}, {147,13,0}, {155,13,0}, {139,13,0},
+    {165,13,0}, {149,13,0}, {157,13,0}, {141,13,0}, {161,13,0}, {145,13,0}, {153,13,0}, {137,13,0},
+    {255,13,0}, {235,13,0}, {247,13,0}, {224,13,0}, {251,13,0}, {230,13,0}, {240,13,0}, {172,13,0},
+    {253,13,0}, {232,13,0}, {245,13,0}, {174,13,0}, {249,13,0}, {227,13,0}, {237,13,0}, {170,13,0},
+    {254,13,0}, {234,13,0}, {246,13,0}, {175,13,0}, {250,13,0}, {228,13,0}, {239,13,0}, {171,13,0},
+    {252,13,0}, {231,13,0}, {241,13,0}, {173,13,0}, {248,13,0}, {226,13,0}, {236,13,0}, {169,13,0}};
+static const code lenroot[256] = {
+    {15,7,0}, {2,3,0}, {5,4,0}, {0,2,0}, {8,5,0}, {1,3,0}, {3,3,0}, {0,2,0},
+    {10,5,0}, {2,3,0}, {4,4,0}, {0,2,0}, {6,4,0}, {1,3,0}, {3,3,0}, {0,2,0},
+    {12,6,0}, {2,3,0}, {5,4,0}, {0,2,0}, {7,5,0}, {1,3,0}, {3,3,0}, {0,2,0},
+    {9,5,0}, {2,3,0}, {4,4,0}, {0,2,0}, {6,4,0}, {1,3,0}, {3,3,0}, {0,2,0},
+    {13,6,0}, {2,3,0}, {5,4,0}, {0,2,0}, {8,5,0}, {1,3,0}, {3,3,0}, {0,2,0},
+    {10,5,0}, {2,3,0}, {4,4,0}, {0,2,0}, {6,4,0}, {1,3,0}, {3,3,0}, {0,2,0},
+    {11,6,0}, {2,3,0}, {5,4,0}, {0,2,0}, {7,5,0}, {1,3,0}, {3,3,0}, {0,2,0},
+    {9,5,0}, {2,3,0}, {4,4,0}, {0,2,0}, {6,4,0}, {1,3,0}, {3,3,0}, {0,2,0},
+    {14,7,0}, {2,3,0}, {5,4,0}, {0,2,0}, {8,5,0}, {1,3,0}, {3,3,0}, {0,2,0},
+    {10,5,0}, {2,3,0}, {4,4,0}, {0,2,0}, {6,4,0}, {1,3,0}, {3,3,0}, {0,2,0},
+    {12,6,0}, {2,3,0}, {5,4,0}, {0,2,0}, {7,5,0}, {1,3,0}, {3,3,0}, {0,2,0},
+    {9,5,0}, {2,3,0}, {4,4,0}, {0,2,0}, {6,4,0}, {1,3,0}, {3,3,0}, {0,2,0},
+    {13,6,0}, {2,3,0}, {5,4,0}, {0,2,0}, {8,5,0}, {1,3,0}, {3,3,0}, {0,2,0},
+    {10,5,0}, {2,3,0}, {4,4,0}, {0,2,0}, {6,4,0}, {1,3,0}, {3,3,0}, {0,2,0},
+    {11,6,0}, {2,3,0}, {5,4,0}, {0,2,0}, {7,5,0}, {1,3,0}, {3,3,0}, {0,2,0},
+    {9,5,0}, {2,3,0}, {4,4,0}, {0,2,0}, {6,4,0}, {1,3,0}, {3,3,0}, {0,2,0},
+    {15,7,0}, {2,3,0}, {5,4,0}, {0,2,0}, {8,5,0}, {1,3,0}, {3,3,0}, {0,2,0},
+    {10,5,0}, {2,3,0}, {4,4,0}, {0,2,0}, {6,4,0}, {1,3,0}, {3,3,0}, {0,2,0},
+    {12,6,0}, {2,3,0}, {5,4,0}, {0,2,0}, {7,5,0}, {1,3,0}, {3,3,0}, {0,2,0},
+    {9,5,0}, {2,3,0}, {4,4,0}, {0,2,0}, {6,4,0}, {1,3,0}, {3,3,0}, {0,2,0},
+    {13,6,0}, {2,3,0}, {5,4,0}, {0,2,0}, {8,5,0}, {1,3,0}, {3,3,0}, {0,2,0},
+    {10,5,0}, {2,3,0}, {4,4,0}, {0,2,0}, {6,4,0}, {1,3,0}, {3,3,0}, {0,2,0},
+    {11,6,0}, {2,3,0}, {5,4,0}, {0,2,0}, {7,5,0}, {1,3,0}, {3,3,0}, {0,2,0},
+    {9,5,0}, {2,3,0}, {4,4,0}, {0,2,0}, {6,4,0}, {1,3,0}, {3,3,0}, {0,2,0},
+    {14,7,0}, {2,3,0}, {5,4,0}, {0,2,0}, {8,5,0}, {1,3,0}, {3,3,0}, {0,2,0},
+    {10,5,0}, {2,3,0}, {4,4,0}, {0,2,0}, {6,4,0}, {1,3,0}, {3,3,0}, {0,2,0},
+    {12,6,0}, {2,3,0}, {5,4,0}, {0,2,0}, {7,5,0}, {1,3,0}, {3,3,0}, {0,2,0},
+    {9,5,0}, {2,3,0}, {4,4,0}, {0,2,0}, {6,4,0}, {1,3,0}, {3,3,0}, {0,2,0},
+    {13,6,0}, {2,3,0}, {5,4,0}, {0,2,0}, {8,5,0}, {1,3,0}, {3,3,0}, {0,2,0},
+    {10,5,0}, {2,3,0}, {4,4,0}, {0,2,0}, {6,4,0}, {1,3,0}, {3,3,0}, {0,2,0},
+    {11,6,0}, {2,3,0}, {5,4,0}, {0,2,0}, {7,5,0}, {1,3,0}, {3,3,0}, {0,2,0},
+    {9,5,0}, {2,3,0}, {4,4,0}, {0,2,0}, {6,4,0}, {1,3,0}, {3,3,0}, {0,2,0}};
+static const code distroot[256] = {
+    {63,8,0}, {6,5,0}, {23,7,0}, {0,2,0}, {39,7,0}, {2,4,0}, {14,6,0}, {0,2,0},
+    {47,7,0}, {4,5,0}, {18,6,0}, {0,2,0}, {31,7,0}, {1,4,0}, {10,6,0}, {0,2,0},
+    {55,8,0}, {5,5,0}, {20,6,0}, {0,2,0}, {35,7,0}, {2,4,0}, {12,6,0}, {0,2,0},
+    {43,7,0}, {3,5,0}, {16,6,0}, {0,2,0}, {27,7,0}, {1,4,0}, {8,6,0}, {0,2,0},
+    {59,8,0}, {6,5,0}, {21,6,0}, {0,2,0}, {37,7,0}, {2,4,0}, {13,6,0}, {0,2,0},
+    {45,7,0}, {4,5,0}, {17,6,0}, {0,2,0}, {29,7,0}, {1,4,0}, {9,6,0}, {0,2,0},
+    {51,8,0}, {5,5,0}, {19,6,0}, {0,2,0}, {33,7,0}, {2,4,0}, {11,6,0}, {0,2,0},
+    {41,7,0}, {3,5,0}, {15,6,0}, {0,2,0}, {25,7,0}, {1,4,0}, {7,6,0}, {0,2,0},
+    {61,8,0}, {6,5,0}, {22,7,0}, {0,2,0}, {38,7,0}, {2,4,0}, {14,6,0}, {0,2,0},
+    {46,7,0}, {4,5,0}, {18,6,0}, {0,2,0}, {30,7,0}, {1,4,0}, {10,6,0}, {0,2,0},
+    {53,8,0}, {5,5,0}, {20,6,0}, {0,2,0}, {34,7,0}, {2,4,0}, {12,6,0}, {0,2,0},
+    {42,7,0}, {3,5,0}, {16,6,0}, {0,2,0}, {26,7,0}, {1,4,0}, {8,6,0}, {0,2,0},
+    {57,8,0}, {6,5,0}, {21,6,0}, {0,2,0}, {36,7,0}, {2,4,0}, {13,6,0}, {0,2,0},
+    {44,7,0}, {4,5,0}, {17,6,0}, {0,2,0}, {28,7,0}, {1,4,0}, {9,6,0}, {0,2,0},
+    {49,8,0}, {5,5,0}, {19,6,0}, {0,2,0}, {32,7,0}, {2,4,0}, {11,6,0}, {0,2,0},
+    {40,7,0}, {3,5,0}, {15,6,0}, {0,2,0}, {24,7,0}, {1,4,0}, {7,6,0}, {0,2,0},
+    {62,8,0}, {6,5,0}, {23,7,0}, {0,2,0}, {39,7,0}, {2,4,0}, {14,6,0}, {0,2,0},
+    {47,7,0}, {4,5,0}, {18,6,0}, {0,2,0}, {31,7,0}, {1,4,0}, {10,6,0}, {0,2,0},
+    {54,8,0}, {5,5,0}, {20,6,0}, {0,2,0}, {35,7,0}, {2,4,0}, {12,6,0}, {0,2,0},
+    {43,7,0}, {3,5,0}, {16,6,0}, {0,2,0}, {27,7,0}, {1,4,0}, {8,6,0}, {0,2,0},
+    {58,8,0}, {6,5,0}, {21,6,0}, {0,2,0}, {37,7,0}, {2,4,0}, {13,6,0}, {0,2,0},
+    {45,7,0}, {4,5,0}, {17,6,0}, {0,2,0}, {29,7,0}, {1,4,0}, {9,6,0}, {0,2,0},
+    {50,8,0}, {5,5,0}, {19,6,0}, {0,2,0}, {33,7,0}, {2,4,0}, {11,6,0}, {0,2,0},
+    {41,7,0}, {3,5,0}, {15,6,0}, {0,2,0}, {25,7,0}, {1,4,0}, {7,6,0}, {0,2,0},
+    {60,8,0}, {6,5,0}, {22,7,0}, {0,2,0}, {38,7,0}, {2,4,0}, {14,6,0}, {0,2,0},
+    {46,7,0}, {4,5,0}, {18,6,0}, {0,2,0}, {30,7,0}, {1,4,0}, {10,6,0}, {0,2,0},
+    {52,8,0}, {5,5,0}, {20,6,0}, {0,2,0}, {34,7,0}, {2,4,0}, {12,6,0}, {0,2,0},
+    {42,7,0}, {3,5,0}, {16,6,0}, {0,2,0}, {26,7,0}, {1,4,0}, {8,6,0}, {0,2,0},
+    {56,8,0}, {6,5,0}, {21,6,0}, {0,2,0}, {36,7,0}, {2,4,0}, {13,6,0}, {0,2,0},
+    {44,7,0}, {4,5,0}, {17,6,0}, {0,2,0}, {28,7,0}, {1,4,0}, {9,6,0}, {0,2,0},
+    {48,8,0}, {5,5,0}, {19,6,0}, {0,2,0}, {32,7,0}, {2,4,0}, {11,6,0}, {0,2,0},
+    {40,7,0}, {3,5,0}, {15,6,0}, {0,2,0}, {24,7,0}, {1,4,0}, {7,6,0}, {0,2,0}};
+
+#ifdef BLAST_REFERENCE
+static const short litcnt[14] = {
+    0, 0, 0, 0, 1, 11, 20, 21, 16, 7, 5, 10, 91, 74};
+static const short litsym[256] = {
+    32, 69, 97, 101, 105, 108, 110, 111, 114, 115, 116, 117, 45, 49, 65, 67,
+    68, 73, 76, 78, 79, 82, 83, 84, 98, 99, 100, 102, 103, 104, 109, 112,
+    10, 13, 40, 41, 44, 46, 48, 50, 51, 52, 53, 55, 56, 61, 66, 70,
+    77, 80, 85, 107, 119, 9, 34, 39, 42, 47, 54, 57, 58, 71, 72, 87,
+    91, 95, 118, 120, 121, 43, 62, 75, 86, 88, 89, 93, 33, 36, 38, 113,
+    122, 0, 60, 63, 74, 81, 90, 92, 106, 123, 124, 1, 2, 3, 4, 5,
+    6, 7, 8, 11, 12, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24,
+    25, 27, 28, 29, 30, 31, 35, 37, 59, 64, 94, 96, 125, 126, 127, 176,
+    177, 178, 179, 180, 181, 182, 183, 184, 185, 186, 187, 188, 189, 190, 191, 192,
+    193, 194, 195, 196, 197, 198, 199, 200, 201, 202, 203, 204, 205, 206, 207, 208,
+    209, 210, 211, 212, 213, 214, 215, 216, 217, 218, 219, 220, 221, 222, 223, 225,
+    229, 233, 238, 242, 243, 244, 26, 128, 129, 130, 131, 132, 133, 134, 135, 136,
+    137, 138, 139, 140, 141, 142, 143, 144, 145, 146, 147, 148, 149, 150, 151, 152,
+    153, 154, 155, 156, 157, 158, 159, 160, 161, 162, 163, 164, 165, 166, 167, 168,
+    169, 170, 171, 172, 173, 174, 175, 224, 226, 227, 228, 230, 231, 232, 234, 235,
+    236, 237, 239, 240, 241, 245, 246, 247, 248, 249, 250, 251, 252, 253, 254, 255};
+static const short lencnt[14] = {
+    0, 0, 1, 3, 3, 4, 3, 2, 0, 0, 0, 0, 0, 0};
+static const short lensym[16] = {
+    0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15};
+static const short distcnt[14] = {
+    0, 0, 1, 0, 2, 4, 15, 26, 16, 0, 0, 0, 0, 0};
+static const short distsym[64] = {
+    0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+    16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31,
+    32, 33, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47,
+    48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 61, 62, 63};
+#endif
@@ -0,0 +1,555 @@
+#include "convert.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <glib.h>
+
+/* Cardinalidade máxima (distintos / não nulos) para dicionário automático:
+   códigos (município, CID, sexo, raça) ficam muito abaixo disso */
+#define CONV_DICT_RATIO 4
+
+int conv_choose_dictionary(DbfCtx *ctx, ColumnSpec *cols, int ncols,
+                           ConvDictMode mode, int sample_rows) {
+    if (mode != CONV_DICT_AUTO) {
+        for (int i = 0; i < ncols; i++)
+            cols[i].dict = cols[i].kind == COL_UTF8 && mode == CONV_DICT_ALWAYS;
+        return 0;
+    }
+
+    DbfCtx view;
+    if (dbf_sample(ctx, sample_rows, &view) != 0) return -1;
+    for (int i = 0; i < ncols; i++) {
+        cols[i].dict = 0;
+        if (cols[i].kind != COL_UTF8) continue;
+        int nonnull = 0;
+        int limit = view.nrecords / CONV_DICT_RATIO + 1;
+        int distinct = dbf_count_distinct(&view, &cols[i], 0, view.nrecords, limit, &nonnull);
+        if (distinct < 0) return -1;
+        cols[i].dict = nonnull > 0 && distinct * CONV_DICT_RATIO <= nonnull;
+    }
+    return 0;
+}
+
+static int find_name(const ColumnSpec *cols, int ncols, const char *name) {
+    for (int i = 0; i < ncols; i++)
+        if (g_ascii_strcasecmp(cols[i].name, name) == 0) return i;
+    return -1;
+}
+
+int conv_project(ColumnSpec *cols, int *ncols, const char *columns, const char *exclude,
+                 char *bad, size_t badlen) {
+    bad[0] = '\0';
+    if (!columns && !exclude) return 0;
+
+    int n = *ncols;
+    ColumnSpec *out = (ColumnSpec*)malloc((size_t)(n ? n : 1) * sizeof(ColumnSpec));
+    int *taken = (int*)calloc((size_t)(n ? n : 1), sizeof(int));
+    if (!out || !taken) { free(out); free(taken); return -1; }
+
+    int m = 0, rc = 0;
+    if (columns) {
+        char **names = g_strsplit(columns, ",", -1);
+        for (int k = 0; rc == 0 && names[k]; k++) {
+            char *name = g_strstrip(names[k]);
+            if (!*name) continue;
+            int i = find_name(cols, n, name);
+            if (i < 0 || taken[i]) {
+                g_strlcpy(bad, name, badlen);
+                rc = -1;
+                break;
+            }
+            taken[i] = 1;
+            out[m++] = cols[i];
+        }
+        g_strfreev(names);
+    } else {
+        memcpy(out, cols, (size_t)n * sizeof(ColumnSpec));
+        m = n;
+    }
+
+    if (rc == 0 && exclude) {
+        char **names = g_strsplit(exclude, ",", -1);
+        for (int k = 0; rc == 0 && names[k]; k++) {
+            char *name = g_strstrip(names[k]);
+            if (!*name) continue;
+            int i = find_name(out, m, name);
+            if (i < 0) {
+                g_strlcpy(bad, name, badlen);
+                rc = -1;
+                break;
+            }
+            memmove(&out[i], &out[i + 1], (size_t)(m - i - 1) * sizeof(ColumnSpec));
+            m--;
+        }
+        g_strfreev(names);
+    }
+
+    if (rc == 0 && m == 0) rc = -1;
+    if (rc == 0) {
+        memcpy(cols, out, (size_t)m * sizeof(ColumnSpec));
+        *ncols = m;
+    }
+    free(taken);
+    free(out);
+    return rc;
+}
+
+static int int_bytes(ColKind k) {
+    switch (k) {
+        case COL_INT8:  return 1;
+        case COL_INT16: return 2;
+        case COL_INT32: return 4;
+        default:        return 8;
+    }
+}
+
+int conv_infer_ints(DbfCtx *ctx, ColumnSpec *cols, int ncols,
+                    ConvInferMode mode, int sample_rows) {
+    if (mode == CONV_INFER_NONE) return 0;
+    dbf_narrow_ints(cols, ncols);
+    if (mode != CONV_INFER_SAMPLE) return 0;
+
+    DbfCtx view;
+    if (dbf_sample(ctx, sample_rows, &view) != 0) return -1;
+    for (int i = 0; i < ncols; i++) {
+        if (!dbf_kind_is_int(cols[i].kind) || cols[i].kind == COL_INT8) continue;
+        int64_t min, max;
+        int nonnull = 0;
+        if (dbf_int_range(&view, &cols[i], 0, view.nrecords, &min, &max, &nonnull) != 0) return -1;
+        if (nonnull == 0) continue; /* amostra sem valores: fica a largura */
+        ColKind k = dbf_int_kind_for_range(min, max);
+        if (int_bytes(k) < int_bytes(cols[i].kind)) cols[i].kind = k;
+    }
+    return 0;
+}
+
+int conv_rows_for_bytes(DbfCtx *ctx, const ColumnSpec *cols, int ncols,
+                        long long target_bytes, int sample_rows) {
+    DbfCtx view;
+    if (dbf_sample(ctx, sample_rows, &view) != 0) return -1;
+
+    double row_bytes = 0;
+    for (int i = 0; i < ncols; i++) {
+        row_bytes += 1.0 / 8;                       /* validade */
+        switch (cols[i].kind) {
+            case COL_BOOL:       row_bytes += 1.0 / 8; break;
+            case COL_INT8:       row_bytes += 1;       break;
+            case COL_INT16:      row_bytes += 2;       break;
+            case COL_INT32:
+            case COL_DATE32:     row_bytes += 4;       break;
+            case COL_INT64:
+            case COL_FLOAT64:    row_bytes += 8;       break;
+            case COL_DECIMAL128: row_bytes += 16;      break;
+            case COL_UTF8:
+            default: {
+                row_bytes += 4;                     /* offset ou índice */
+                if (cols[i].dict) break;            /* valores distintos: desprezíveis */
+                int nonnull = 0;
+                long long bytes = dbf_text_bytes(&view, &cols[i], 0, view.nrecords, &nonnull);
+                if (bytes < 0) return -1;
+                row_bytes += view.nrecords > 0 ? (double)bytes / view.nrecords : cols[i].width;
+                break;
+            }
+        }
+    }
+
+    /* nunca maior que o arquivo: sel e os buffers são alocados por lote */
+    double rows = (double)target_bytes / row_bytes;
+    if (rows > ctx->nrecords) rows = ctx->nrecords;
+    return rows < 1 ? 1 : (int)rows;
+}
+
+/* Seleção de linhas por lote: deletados pulados e/ou --where */
+static int needs_sel(const ConvOpts *o) {
+    return !o->keep_deleted || o->where;
+}
+
+/* Registros [*row, *row + *n) do lote `chunk` (lotes contados a partir de first_row). */
+static void chunk_range(const DbfCtx *ctx, const ConvOpts *o, int chunk, int *row, int *n) {
+    *row = o->first_row + chunk * o->batch_size;
+    *n = ctx->nrecords - *row < o->batch_size ? ctx->nrecords - *row : o->batch_size;
+}
+
+/* Decodifica o lote `chunk` em *out. `ctx` é a visão devolvida por dbf_fetch()
+   para o lote; `sel` tem capacidade batch_size. Conta as linhas em *st.
+   Retorna CONV_OK ou CONV_ERR_*. */
+static int decode_chunk(const DbfCtx *ctx, const ColumnSpec *cols, int ncols, GArrowSchema *schema,
+                        const ConvOpts *o, int chunk, EncCtx *enc, int *sel,
+                        GArrowRecordBatch **out, int *err_row, ConvStats *st)
+{
+    int row, n;
+    chunk_range(ctx, o, chunk, &row, &n);
+    *out = NULL;
+    st->rows_read += n;
+    st->record_bytes += (long long)n * ctx->record_len;
+
+    /* readahead do próximo lote enquanto este é convertido */
+    dbf_prefetch(ctx, row + n, o->batch_size);
+
+    int ndel = 0;
+    if (!o->keep_deleted) {
+        ndel = dbf_scan_deleted(ctx, row, n, sel);
+        if (ndel < 0) { *err_row = row; return CONV_ERR_DELETED; }
+    }
+    /* lote sem deletados dispensa a seleção */
+    const int *active = ndel ? sel : NULL;
+    int nactive = n - ndel;
+
+    st->rows_deleted += ndel;
+
+    /* --where nos bytes crus: as linhas descartadas nem chegam a ser decodificadas */
+    if (o->where) {
+        int before = nactive;
+        nactive = where_select(o->where, ctx, row, active, nactive, sel);
+        active = sel;
+        st->rows_filtered += before - nactive;
+    }
+
+    /* decodifica coluna a coluna */
+    *err_row = row;
+    int drc = aw_decode_batch(schema, cols, ncols, ctx, row,
+                              active, nactive,
+                              enc, o->strict, out, err_row);
+    if (drc == -1) return CONV_ERR_ENCODING;
+    if (drc == -3) return CONV_ERR_RANGE;
+    if (drc != 0)  return CONV_ERR_WRITE;
+    st->rows_emitted += nactive;
+    return CONV_OK;
+}
+
+/* Entrega um lote ao sink (e o checkpoint do registro seguinte); conta o row group.
+   0 ok. */
+static int sink_deliver(const ConvSink *sink, GArrowRecordBatch *batch, int next_row, ConvStats *st) {
+    StageMark m = stats_begin();
+    int rc = sink->write(sink->user, batch);
+    if (rc == 0 && sink->checkpoint) rc = sink->checkpoint(sink->user, next_row);
+    if (rc == 0 && garrow_record_batch_get_n_rows(batch) > 0) st->row_groups++;
+    stats_end(&st->write, m);
+    return rc;
+}
+
+/* Lotes decodificados ainda não entregues: com --where (ou muitos deletados) um
+   lote sai bem menor que batch_size, e entregar cada um viraria um row group
+   minúsculo. Os lotes são juntados até batch_size linhas (sem passar disso e
+   sem partir lote, para o checkpoint continuar na fronteira de um lote). */
+typedef struct {
+    GPtrArray *batches;        /* GArrowRecordBatch* na ordem dos registros */
+    gint64     rows;
+    int        next_row;       /* registro seguinte ao último lote guardado */
+} Pending;
+
+static void pending_init(Pending *pd) {
+    pd->batches = g_ptr_array_new_with_free_func(g_object_unref);
+    pd->rows = 0;
+    pd->next_row = 0;
+}
+
+static void pending_clear(Pending *pd) {
+    g_ptr_array_free(pd->batches, TRUE);
+}
+
+/* Entrega o que estiver guardado como um lote só. 0 ok. */
+static int pending_flush(Pending *pd, GArrowSchema *schema, const ConvSink *sink, ConvStats *st) {
+    if (pd->batches->len == 0) return 0;
+    GArrowRecordBatch *batch;
+    if (pd->batches->len == 1) {
+        batch = g_object_ref(g_ptr_array_index(pd->batches, 0));
+    } else {
+        StageMark m = stats_begin();
+        batch = aw_concat_batches(schema, (GArrowRecordBatch**)pd->batches->pdata,
+                                  (int)pd->batches->len);
+        stats_end(&st->write, m);
+        if (!batch) return -1;
+    }
+    int rc = sink_deliver(sink, batch, pd->next_row, st);
+    g_object_unref(batch);
+    g_ptr_array_set_size(pd->batches, 0);
+    pd->rows = 0;
+    return rc;
+}
+
+/* Guarda `batch` (lote que termina antes de `next_row`) e entrega quando
+   completa `target` linhas. Lote vazio com nada guardado vai direto ao sink
+   (avança o checkpoint). 0 ok. */
+static int pending_add(Pending *pd, GArrowRecordBatch *batch, int next_row, int target,
+                       GArrowSchema *schema, const ConvSink *sink, ConvStats *st)
+{
+    gint64 n = garrow_record_batch_get_n_rows(batch);
+    if (n == 0 && pd->batches->len == 0) return sink_deliver(sink, batch, next_row, st);
+    if (pd->rows + n > target && pending_flush(pd, schema, sink, st) != 0) return -1;
+    if (n > 0) {
+        g_ptr_array_add(pd->batches, g_object_ref(batch));
+        pd->rows += n;
+    }
+    pd->next_row = next_row;
+    if (pd->rows >= target) return pending_flush(pd, schema, sink, st);
+    return 0;
+}
+
+/* Textos transcodificados por um EncCtx, antes do enc_close() */
+static void count_strings(ConvStats *st, const EncCtx *enc) {
+    st->strings_transcoded += enc->transcoded;
+    st->strings_replaced   += enc->replaced;
+}
+
+/* --- modo sequencial --- */
+static int run_sequential(DbfCtx *ctx, const ColumnSpec *cols, int ncols, GArrowSchema *schema,
+                          const char *from_cp, const ConvSink *sink,
+                          const ConvOpts *o, int nchunks, int *err_row)
+{
+    EncCtx enc;
+    if (enc_open(&enc, from_cp) != 0) return CONV_ERR_DELETED;
+
+    int *sel = NULL;
+    if (needs_sel(o)) {
+        sel = (int*)malloc((size_t)o->batch_size * sizeof(int));
+        if (!sel) { enc_close(&enc); return CONV_ERR_DELETED; }
+    }
+
+    ConvStats st;
+    memset(&st, 0, sizeof(st));
+    Pending pd;
+    pending_init(&pd);
+    int rc = CONV_OK;
+    for (int chunk = 0; rc == CONV_OK && chunk < nchunks; chunk++) {
+        int row, n;
+        chunk_range(ctx, o, chunk, &row, &n);
+        DbfCtx view;
+        unsigned char *owned = NULL;
+        StageMark m = stats_begin();
+        int frc = dbf_fetch(ctx, row, n, &view, &owned);
+        stats_end(&st.fetch, m);
+        if (frc != 0) {
+            *err_row = row;
+            rc = CONV_ERR_DELETED;
+            break;
+        }
+
+        GArrowRecordBatch *batch = NULL;
+        m = stats_begin();
+        rc = decode_chunk(&view, cols, ncols, schema, o, chunk, &enc, sel, &batch, err_row, &st);
+        stats_end(&st.decode, m);
+        free(owned); /* o batch já tem cópia própria dos valores */
+        if (rc == CONV_OK && pending_add(&pd, batch, row + n, o->batch_size, schema, sink, &st) != 0)
+            rc = CONV_ERR_WRITE;
+        if (batch) g_object_unref(batch);
+    }
+    if (rc == CONV_OK && pending_flush(&pd, schema, sink, &st) != 0) rc = CONV_ERR_WRITE;
+    pending_clear(&pd);
+
+    count_strings(&st, &enc);
+    if (o->stats) stats_add_conv(o->stats, &st);
+    free(sel);
+    enc_close(&enc);
+    return rc;
+}
+
+/* --- modo paralelo: workers decodificam, o chamador escreve em ordem ---
+   No máximo `window` lotes prontos/em andamento à frente do writer, para a
+   memória continuar limitada por batch_size × threads. */
+typedef struct {
+    DbfCtx           *ctx;
+    const ColumnSpec *cols;
+    int               ncols;
+    GArrowSchema     *schema;
+    const char       *from_cp;
+    const ConvOpts   *opts;
+    int               nchunks;
+    int               window;
+
+    GMutex fetch_lock;         /* dbf_fetch() em ordem de lote (streams só avançam) */
+    GMutex lock;
+    GCond  can_take;           /* writer avançou / erro */
+    GCond  ready;              /* um lote ficou pronto / erro */
+    int    next_chunk;         /* próximo lote a distribuir */
+    int    next_write;         /* próximo lote a escrever */
+    GArrowRecordBatch **slots; /* lote c em slots[c % window] */
+    ConvStats stats;           /* contadores dos workers, somados ao terminar */
+
+    int    failed;             /* 1 = parar */
+    int    err_chunk;          /* menor lote com erro (nchunks = nenhum) */
+    int    err_rc;
+    int    err_row;
+} Pipeline;
+
+static void pipeline_fail(Pipeline *p, int chunk, int rc, int row) {
+    /* chamado com p->lock: guarda o erro do menor lote, como no sequencial */
+    p->failed = 1;
+    if (chunk < p->err_chunk) {
+        p->err_chunk = chunk;
+        p->err_rc = rc;
+        p->err_row = row;
+    }
+    g_cond_broadcast(&p->can_take);
+    g_cond_broadcast(&p->ready);
+}
+
+static gpointer worker_main(gpointer data) {
+    Pipeline *p = (Pipeline*)data;
+    const ConvOpts *o = p->opts;
+
+    EncCtx enc;
+    int enc_ok = enc_open(&enc, p->from_cp) == 0;
+    int *sel = needs_sel(o) ? (int*)malloc((size_t)o->batch_size * sizeof(int)) : NULL;
+    if (!enc_ok || (needs_sel(o) && !sel)) {
+        g_mutex_lock(&p->lock);
+        pipeline_fail(p, p->next_chunk, CONV_ERR_DELETED, -1);
+        g_mutex_unlock(&p->lock);
+        if (enc_ok) enc_close(&enc);
+        free(sel);
+        return NULL;
+    }
+
+    ConvStats st;
+    memset(&st, 0, sizeof(st));
+    for (;;) {
+        /* pegar o lote e buscar seus registros sem soltar fetch_lock: assim uma
+           stream é lida na ordem dos lotes; a decodificação segue em paralelo */
+        g_mutex_lock(&p->fetch_lock);
+        g_mutex_lock(&p->lock);
+        while (!p->failed && p->next_chunk < p->nchunks &&
+               p->next_chunk >= p->next_write + p->window)
+            g_cond_wait(&p->can_take, &p->lock);
+        if (p->failed || p->next_chunk >= p->nchunks) {
+            g_mutex_unlock(&p->lock);
+            g_mutex_unlock(&p->fetch_lock);
+            break;
+        }
+        int chunk = p->next_chunk++;
+        g_mutex_unlock(&p->lock);
+
+        int row, n;
+        chunk_range(p->ctx, o, chunk, &row, &n);
+        DbfCtx view;
+        unsigned char *owned = NULL;
+        StageMark m = stats_begin();
+        int frc = dbf_fetch(p->ctx, row, n, &view, &owned);
+        stats_end(&st.fetch, m);
+        g_mutex_unlock(&p->fetch_lock);
+
+        GArrowRecordBatch *batch = NULL;
+        int err_row = row;
+        m = stats_begin();
+        int rc = frc != 0 ? CONV_ERR_DELETED
+                          : decode_chunk(&view, p->cols, p->ncols, p->schema, o, chunk, &enc, sel, &batch, &err_row, &st);
+        stats_end(&st.decode, m);
+        free(owned);
+
+        g_mutex_lock(&p->lock);
+        if (rc == CONV_OK) {
+            p->slots[chunk % p->window] = batch;
+            g_cond_broadcast(&p->ready);
+        } else {
+            if (batch) g_object_unref(batch);
+            pipeline_fail(p, chunk, rc, err_row);
+        }
+        g_mutex_unlock(&p->lock);
+    }
+
+    count_strings(&st, &enc);
+    g_mutex_lock(&p->lock);
+    stats_add_conv(&p->stats, &st);
+    g_mutex_unlock(&p->lock);
+    free(sel);
+    enc_close(&enc);
+    return NULL;
+}
+
+static int run_parallel(DbfCtx *ctx, const ColumnSpec *cols, int ncols, GArrowSchema *schema,
+                        const char *from_cp, const ConvSink *sink,
+                        const ConvOpts *o, int nchunks, int *err_row)
+{
+    Pipeline p;
+    memset(&p, 0, sizeof(p));
+    p.ctx = ctx;
+    p.cols = cols;
+    p.ncols = ncols;
+    p.schema = schema;
+    p.from_cp = from_cp;
+    p.opts = o;
+    p.nchunks = nchunks;
+    p.window = 2 * o->threads;
+    p.err_chunk = nchunks;
+    p.slots = g_new0(GArrowRecordBatch*, p.window);
+    g_mutex_init(&p.fetch_lock);
+    g_mutex_init(&p.lock);
+    g_cond_init(&p.can_take);
+    g_cond_init(&p.ready);
+
+    GThread **threads = g_new0(GThread*, o->threads);
+    for (int t = 0; t < o->threads; t++)
+        threads[t] = g_thread_new("dbf2parquet-decode", worker_main, &p);
+
+    /* sequenciador: escreve o lote next_write assim que ele fica pronto */
+    ConvStats wst;
+    memset(&wst, 0, sizeof(wst));
+    Pending pd;
+    pending_init(&pd);
+    for (;;) {
+        g_mutex_lock(&p.lock);
+        while (!p.failed && p.next_write < nchunks && !p.slots[p.next_write % p.window])
+            g_cond_wait(&p.ready, &p.lock);
+        if (p.failed || p.next_write >= nchunks) {
+            g_mutex_unlock(&p.lock);
+            break;
+        }
+        int chunk = p.next_write;
+        GArrowRecordBatch *batch = p.slots[chunk % p.window];
+        p.slots[chunk % p.window] = NULL;
+        g_mutex_unlock(&p.lock);
+
+        int row, n;
+        chunk_range(ctx, o, chunk, &row, &n);
+        int wrc = pending_add(&pd, batch, row + n, o->batch_size, schema, sink, &wst);
+        g_object_unref(batch);
+
+        g_mutex_lock(&p.lock);
+        if (wrc != 0) pipeline_fail(&p, chunk, CONV_ERR_WRITE, -1);
+        p.next_write++;
+        g_cond_broadcast(&p.can_take);
+        g_mutex_unlock(&p.lock);
+    }
+
+    for (int t = 0; t < o->threads; t++) g_thread_join(threads[t]);
+    g_free(threads);
+    if (!p.failed && pending_flush(&pd, schema, sink, &wst) != 0)
+        pipeline_fail(&p, nchunks - 1, CONV_ERR_WRITE, -1);
+    pending_clear(&pd);
+    if (o->stats) {
+        stats_add_conv(o->stats, &p.stats);
+        stats_add_conv(o->stats, &wst);
+    }
+
+    for (int i = 0; i < p.window; i++)
+        if (p.slots[i]) g_object_unref(p.slots[i]);
+    g_free(p.slots);
+    g_cond_clear(&p.ready);
+    g_cond_clear(&p.can_take);
+    g_mutex_clear(&p.lock);
+    g_mutex_clear(&p.fetch_lock);
+
+    if (p.err_chunk < nchunks) {
+        if (p.err_row >= 0) *err_row = p.err_row;
+        return p.err_rc;
+    }
+    return CONV_OK;
+}
+
+int conv_run(DbfCtx *ctx, const ColumnSpec *cols, int ncols, GArrowSchema *schema,
+             const char *from_cp, const ConvSink *sink,
+             const ConvOpts *opts, int *err_row)
+{
+    *err_row = -1;
+    ConvOpts o = *opts;
+    if (o.row_group_bytes > 0) {
+        o.batch_size = conv_rows_for_bytes(ctx, cols, ncols, o.row_group_bytes, opts->batch_size);
+        if (o.batch_size < 0) { *err_row = 0; return CONV_ERR_DELETED; }
+    }
+    opts = &o;
+    long long remaining = ctx->nrecords > opts->first_row ? ctx->nrecords - opts->first_row : 0;
+    int nchunks = (int)((remaining + opts->batch_size - 1) / opts->batch_size);
+
+    if (opts->threads <= 1 || nchunks <= 1)
+        return run_sequential(ctx, cols, ncols, schema, from_cp, sink, opts, nchunks, err_row);
+    return run_parallel(ctx, cols, ncols, schema, from_cp, sink, opts, nchunks, err_row);
+}
@@ -0,0 +1,104 @@
+#ifndef CONVERT_H
+#define CONVERT_H
+
+#include "dbf_reader.h"
+#include "arrow_writer.h"
+#include "where.h"
+#include "stats.h"
+
+/* Códigos de retorno (iguais aos códigos de saída do dbf2parquet) */
+enum {
+    CONV_OK           = 0,
+    CONV_ERR_DELETED  = 5,   /* falha lendo registros / flags de deletado / sem memória */
+    CONV_ERR_ENCODING = 6,   /* conversão de encoding (strict) */
+    CONV_ERR_WRITE    = 7,   /* montagem do batch ou escrita Parquet */
+    CONV_ERR_RANGE    = 9    /* inteiro fora da faixa da amostra de --infer sample */
+};
+
+typedef struct {
+    int batch_size;          /* registros por lote; também o máximo de linhas por row group */
+    int keep_deleted;        /* 0 = pula registros deletados */
+    int strict;              /* --encoding-strict */
+    int threads;             /* threads de decodificação (<= 1: sem threads) */
+    long long row_group_bytes; /* > 0: registros por lote estimados para este nº de bytes
+                                  descomprimidos (conv_rows_for_bytes); batch_size vira
+                                  só o tamanho da amostra */
+    const WhereFilter *where;  /* --where: só as linhas que passam (NULL = todas) */
+    int first_row;             /* converte só [first_row, nrecords) (--incremental; exige
+                                  arquivo mapeado, 0 = todos) */
+    ConvStats *stats;          /* --stats: contadores e tempos somados aqui (NULL = não mede) */
+} ConvOpts;
+
+/* --dictionary: colunas texto como dictionary<int32, utf8> */
+typedef enum {
+    CONV_DICT_AUTO,          /* só as de baixa cardinalidade na amostra */
+    CONV_DICT_ALWAYS,
+    CONV_DICT_NEVER
+} ConvDictMode;
+
+/* Marca col->dict nas colunas COL_UTF8 conforme `mode`. Em AUTO, amostra os
+   primeiros `sample_rows` registros (dbf_sample: numa stream eles não são
+   perdidos) e escolhe as colunas com no máximo 1 valor distinto para cada
+   CONV_DICT_RATIO não nulos. Chamar antes de aw_build_schema() e conv_run().
+   Retorna 0 ok, -1 erro lendo a amostra. */
+int conv_choose_dictionary(DbfCtx *ctx, ColumnSpec *cols, int ncols,
+                           ConvDictMode mode, int sample_rows);
+
+/* --columns/--exclude: reduz `cols` (*ncols entradas, no lugar) às colunas de
+   `columns` (lista separada por vírgulas, na ordem dada; NULL = todas) menos
+   as de `exclude`. Nomes sem diferença de maiúsculas. Colunas fora da projeção
+   nunca são lidas nem convertidas. Retorna 0 ok; -1 nome inexistente ou
+   repetido (copiado em `bad`), ou projeção vazia (bad = ""). */
+int conv_project(ColumnSpec *cols, int *ncols, const char *columns, const char *exclude,
+                 char *bad, size_t badlen);
+
+/* --infer: tipo das colunas inteiras (N/F sem decimais) */
+typedef enum {
+    CONV_INFER_WIDTH,        /* pela largura declarada, só campos N (dbf_narrow_ints);
+                                valor que não cabe fica NULL */
+    CONV_INFER_SAMPLE,       /* pela faixa de valores da amostra, nunca mais largo que WIDTH */
+    CONV_INFER_NONE          /* tudo int64 */
+} ConvInferMode;
+
+/* Estreita as colunas COL_INT64 de `cols` conforme `mode`. Em SAMPLE, lê os
+   primeiros `sample_rows` registros (dbf_sample) e usa o menor tipo que
+   comporta o menor e o maior valor vistos; um valor posterior fora dessa faixa
+   faz conv_run() falhar com CONV_ERR_RANGE. Chamar antes de aw_build_schema()
+   e conv_run(). Retorna 0 ok, -1 erro lendo a amostra. */
+int conv_infer_ints(DbfCtx *ctx, ColumnSpec *cols, int ncols,
+                    ConvInferMode mode, int sample_rows);
+
+/* Registros por lote para que um row group tenha ~target_bytes descomprimidos
+   (buffers Arrow: valores, offsets e validade). Tipos fixos pelo tamanho do
+   tipo; texto pelo comprimento médio nos primeiros `sample_rows` registros
+   (dbf_sample), ou pela largura se a amostra estiver vazia. Retorna de 1 a
+   ctx->nrecords, ou -1 erro lendo a amostra. */
+int conv_rows_for_bytes(DbfCtx *ctx, const ColumnSpec *cols, int ncols,
+                        long long target_bytes, int sample_rows);
+
+/* Destino dos lotes: write() recebe os RecordBatches na ordem original, sempre
+   na thread que chamou conv_run (0 ok). Ex.: aw_write_batch num writer aberto.
+   checkpoint() (opcional) é chamado depois de cada write() bem-sucedido com o
+   registro seguinte ao lote: tudo antes dele já está no sink (--resume). */
+typedef struct {
+    int  (*write)(void *user, GArrowRecordBatch *batch);
+    void  *user;
+    int  (*checkpoint)(void *user, int next_row);
+} ConvSink;
+
+/* Converte os registros de `ctx` (a partir de opts->first_row) em lotes de opts->batch_size (ou do
+   tamanho de opts->row_group_bytes) e entrega
+   cada lote a `sink` (um row group por lote), na ordem original dos registros.
+   Lotes que saem pequenos (--where, deletados) são juntados antes do write(),
+   sem passar de batch_size linhas nem partir um lote.
+   `cols` tem `ncols` colunas, na ordem do `schema`.
+   Com threads > 1, os lotes são decodificados em paralelo (cada thread com seu
+   próprio EncCtx) e um sequenciador entrega os RecordBatches ao sink em ordem:
+   a saída é idêntica à do modo sequencial. Os registros de cada lote vêm de
+   dbf_fetch(), em ordem (funciona também com `ctx` em modo stream, ex. .dbc).
+   Retorna CONV_OK ou um CONV_ERR_*; em erro, *err_row recebe a linha (se houver). */
+int conv_run(DbfCtx *ctx, const ColumnSpec *cols, int ncols, GArrowSchema *schema,
+             const char *from_cp, const ConvSink *sink,
+             const ConvOpts *opts, int *err_row);
+
+#endif
@@ -0,0 +1,147 @@
+#include "dbc_reader.h"
+#include "blast.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <glib.h>
+
+#define DBC_IN_CHUNK  (1 << 16)   /* leitura do arquivo comprimido */
+#define DBC_RING_SIZE (4 << 20)   /* bytes descompactados à frente do consumidor */
+
+/* Produtor (thread do blast) → anel limitado → consumidor (dbf_fetch) */
+struct DbfStream {
+    FILE *in;
+    unsigned char inbuf[DBC_IN_CHUNK];
+
+    GThread *thread;
+    GMutex   lock;
+    GCond    data;         /* chegaram bytes / fim */
+    GCond    space;        /* consumidor liberou espaço / cancelado */
+    unsigned char *ring;
+    size_t   head;         /* posição de leitura */
+    size_t   fill;         /* bytes disponíveis */
+    int      done;         /* blast() terminou */
+    int      status;       /* retorno do blast() */
+    int      cancel;       /* consumidor desistiu: produtor para */
+};
+
+/* Entrada do blast(): blocos do arquivo */
+static unsigned dbc_in(void *how, unsigned char **buf) {
+    DbfStream *s = (DbfStream*)how;
+    *buf = s->inbuf;
+    return (unsigned)fread(s->inbuf, 1, sizeof(s->inbuf), s->in);
+}
+
+/* Saída do blast(): copia para o anel, esperando espaço (len <= 4096) */
+static int dbc_out(void *how, unsigned char *buf, unsigned len) {
+    DbfStream *s = (DbfStream*)how;
+    g_mutex_lock(&s->lock);
+    while (!s->cancel && DBC_RING_SIZE - s->fill < len)
+        g_cond_wait(&s->space, &s->lock);
+    if (s->cancel) { g_mutex_unlock(&s->lock); return 1; }
+
+    size_t tail = (s->head + s->fill) % DBC_RING_SIZE;
+    size_t first = DBC_RING_SIZE - tail < len ? DBC_RING_SIZE - tail : len;
+    memcpy(s->ring + tail, buf, first);
+    memcpy(s->ring, buf + first, len - first);
+    s->fill += len;
+    g_cond_signal(&s->data);
+    g_mutex_unlock(&s->lock);
+    return 0;
+}
+
+static gpointer dbc_thread(gpointer data) {
+    DbfStream *s = (DbfStream*)data;
+    int rc = blast(dbc_in, s, dbc_out, s);
+    g_mutex_lock(&s->lock);
+    s->done = 1;
+    s->status = rc;
+    g_cond_broadcast(&s->data);
+    g_mutex_unlock(&s->lock);
+    return NULL;
+}
+
+static int dbc_read(DbfStream *s, unsigned char *dst, size_t len) {
+    g_mutex_lock(&s->lock);
+    while (len > 0) {
+        while (s->fill == 0 && !s->done)
+            g_cond_wait(&s->data, &s->lock);
+        if (s->fill == 0) break; /* acabou antes de completar */
+
+        size_t take = s->fill < len ? s->fill : len;
+        size_t first = DBC_RING_SIZE - s->head < take ? DBC_RING_SIZE - s->head : take;
+        memcpy(dst, s->ring + s->head, first);
+        memcpy(dst + first, s->ring, take - first);
+        s->head = (s->head + take) % DBC_RING_SIZE;
+        s->fill -= take;
+        dst += take;
+        len -= take;
+        g_cond_signal(&s->space);
+    }
+    int status = s->status;
+    g_mutex_unlock(&s->lock);
+
+    if (len > 0) {
+        if (status != 0) fprintf(stderr, "dbc: blast error: %d\n", status);
+        else             fprintf(stderr, "dbc: dados descompactados terminaram antes do último registro\n");
+        return -1;
+    }
+    return 0;
+}
+
+static void dbc_close(DbfStream *s) {
+    g_mutex_lock(&s->lock);
+    s->cancel = 1;
+    g_cond_broadcast(&s->space);
+    g_mutex_unlock(&s->lock);
+    g_thread_join(s->thread);
+
+    g_cond_clear(&s->space);
+    g_cond_clear(&s->data);
+    g_mutex_clear(&s->lock);
+    fclose(s->in);
+    g_free(s->ring);
+    g_free(s);
+}
+
+static const DbfStreamOps dbc_ops = { dbc_read, dbc_close };
+
+int dbc_is_dbc_path(const char *path) {
+    const char *dot = strrchr(path, '.');
+    return dot && g_ascii_strcasecmp(dot, ".dbc") == 0;
+}
+
+int dbc_open(const char *path, DbfCtx *ctx, ColumnSpec **cols_out) {
+    FILE *in = fopen(path, "rb");
+    if (!in) {
+        fprintf(stderr, "dbc_open: fopen('%s') falhou: %s\n", path, strerror(errno));
+        return -1;
+    }
+
+    /* header DBF não comprimido (mesmo layout do .dbf) */
+    if (dbf_read_header(path, ctx, cols_out) != 0) { fclose(in); return -4; }
+
+    /* 4 bytes (CRC) entre o header e o fluxo DCL */
+    if (fseek(in, ctx->header_len + 4, SEEK_SET) != 0) {
+        fprintf(stderr, "dbc_open: fseek falhou em '%s'\n", path);
+        free(*cols_out);
+        *cols_out = NULL;
+        fclose(in);
+        return -2;
+    }
+
+    DbfStream *s = g_new0(DbfStream, 1);
+    s->in = in;
+    s->ring = (unsigned char*)g_malloc(DBC_RING_SIZE);
+    g_mutex_init(&s->lock);
+    g_cond_init(&s->data);
+    g_cond_init(&s->space);
+    s->thread = g_thread_new("dbf2parquet-dbc", dbc_thread, s);
+
+    ctx->stream = s;
+    ctx->stream_ops = &dbc_ops;
+    ctx->next_row = 0;
+    return 0;
+}
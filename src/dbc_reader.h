@@ -0,0 +1,16 @@
+#ifndef DBC_READER_H
+#define DBC_READER_H
+
+#include "dbf_reader.h"
+
+/* Abre um .dbc (DBF comprimido PKWare DCL, formato DATASUS) sem arquivo
+   temporário: o header DBF (não comprimido) vira o schema e uma thread
+   descompacta os registros com blast() para um buffer limitado, de onde
+   dbf_fetch() os consome em ordem. dbf_close() encerra a thread.
+   Retorna 0 ok, < 0 erro. */
+int dbc_open(const char *path, DbfCtx *ctx, ColumnSpec **cols_out);
+
+/* 1 se o caminho termina em .dbc (sem diferenciar maiúsculas) */
+int dbc_is_dbc_path(const char *path);
+
+#endif
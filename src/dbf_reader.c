@@ -6,6 +6,21 @@
 #include <stdio.h>
 #include <ctype.h>
 #include <errno.h>
+#include <stdint.h>
+#include <limits.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
 
 #include "shapefil.h" /* DBFOpen, DBFGetFieldInfo, etc */
 
@@ -34,6 +49,249 @@ static void dump_header_min(const char *path) {
             (unsigned)h[0], header_len, record_len);
 }
 
+/* Mapeia o arquivo inteiro somente-leitura; retorna 0 ok, -1 erro */
+static int map_file(const char *path, DbfCtx *ctx) {
+#ifdef _WIN32
+    HANDLE f = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                           FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (f == INVALID_HANDLE_VALUE) {
+        fprintf(stderr, "dbf_open: CreateFile('%s') falhou (%lu)\n", path, (unsigned long)GetLastError());
+        return -1;
+    }
+    LARGE_INTEGER sz;
+    if (!GetFileSizeEx(f, &sz) || sz.QuadPart == 0) {
+        fprintf(stderr, "dbf_open: arquivo vazio ou sem tamanho: '%s'\n", path);
+        CloseHandle(f);
+        return -1;
+    }
+    HANDLE m = CreateFileMappingA(f, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!m) {
+        fprintf(stderr, "dbf_open: CreateFileMapping('%s') falhou (%lu)\n", path, (unsigned long)GetLastError());
+        CloseHandle(f);
+        return -1;
+    }
+    const void *p = MapViewOfFile(m, FILE_MAP_READ, 0, 0, 0);
+    if (!p) {
+        fprintf(stderr, "dbf_open: MapViewOfFile('%s') falhou (%lu)\n", path, (unsigned long)GetLastError());
+        CloseHandle(m);
+        CloseHandle(f);
+        return -1;
+    }
+    ctx->map_file   = f;
+    ctx->map_handle = m;
+    ctx->map        = (const unsigned char*)p;
+    ctx->map_len    = (size_t)sz.QuadPart;
+    return 0;
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        fprintf(stderr, "dbf_open: open('%s') falhou: %s\n", path, strerror(errno));
+        return -1;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        fprintf(stderr, "dbf_open: arquivo vazio ou fstat falhou: '%s'\n", path);
+        close(fd);
+        return -1;
+    }
+    void *p = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); /* o mapeamento continua válido sem o descritor */
+    if (p == MAP_FAILED) {
+        fprintf(stderr, "dbf_open: mmap('%s') falhou: %s\n", path, strerror(errno));
+        return -1;
+    }
+    /* leitura sequencial: readahead agressivo e descarte atrás */
+    posix_madvise(p, (size_t)st.st_size, POSIX_MADV_SEQUENTIAL);
+    ctx->map     = (const unsigned char*)p;
+    ctx->map_len = (size_t)st.st_size;
+    return 0;
+#endif
+}
+
+static void unmap_file(DbfCtx *ctx) {
+    if (!ctx->map) return;
+#ifdef _WIN32
+    UnmapViewOfFile(ctx->map);
+    CloseHandle((HANDLE)ctx->map_handle);
+    CloseHandle((HANDLE)ctx->map_file);
+    ctx->map_handle = NULL;
+    ctx->map_file   = NULL;
+#else
+    munmap((void*)ctx->map, ctx->map_len);
+#endif
+    ctx->map = NULL;
+    ctx->map_len = 0;
+}
+
+/* Tipo shapelib → tipo Arrow normalizado */
+static ColKind kind_for(DBFFieldType t, int decimals) {
+    switch (t) {
+        case FTString:
+        case FTInvalid: /* defensivo */
+            return COL_UTF8;
+
+        case FTInteger:
+            return COL_INT64;
+
+        case FTDouble:
+            return (decimals > 0 ? COL_FLOAT64 : COL_INT64);
+
+        case FTLogical:
+            return COL_BOOL;
+
+        case FTDate:
+            return COL_DATE32;
+
+        default:
+            return COL_UTF8;
+    }
+}
+
+/* Mesma regra de DBFGetFieldInfo() do shapelib para o tipo nativo */
+static DBFFieldType field_type_for(char native, int width, int decimals) {
+    switch (native) {
+        case 'L': return FTLogical;
+        case 'D': return FTDate;
+        case 'N':
+        case 'F': return (decimals > 0 || width >= 10) ? FTDouble : FTInteger;
+        default:  return FTString;
+    }
+}
+
+void dbf_map_decimals(ColumnSpec *cols, int ncols) {
+    for (int i = 0; i < ncols; i++) {
+        ColumnSpec *c = &cols[i];
+        if (c->type == 'N' && c->kind == COL_FLOAT64 &&
+            c->decimals > 0 && c->decimals < c->width && c->width <= 20)
+            c->kind = COL_DECIMAL128;
+    }
+}
+
+/* Bytes de um tipo inteiro */
+static int int_kind_bytes(ColKind k) {
+    switch (k) {
+        case COL_INT8:  return 1;
+        case COL_INT16: return 2;
+        case COL_INT32: return 4;
+        default:        return 8;
+    }
+}
+
+ColKind dbf_width_int_kind(const ColumnSpec *col) {
+    if (col->type != 'N' || col->offset < 0) return COL_INT64;
+    if (col->width <= 2) return COL_INT8;
+    if (col->width <= 4) return COL_INT16;
+    if (col->width <= 9) return COL_INT32;
+    return COL_INT64;
+}
+
+void dbf_narrow_ints(ColumnSpec *cols, int ncols) {
+    for (int i = 0; i < ncols; i++)
+        if (cols[i].kind == COL_INT64) cols[i].kind = dbf_width_int_kind(&cols[i]);
+}
+
+ColKind dbf_int_kind_for_range(int64_t min, int64_t max) {
+    if (min >= INT8_MIN && max <= INT8_MAX)   return COL_INT8;
+    if (min >= INT16_MIN && max <= INT16_MAX) return COL_INT16;
+    if (min >= INT32_MIN && max <= INT32_MAX) return COL_INT32;
+    return COL_INT64;
+}
+
+int dbf_parse_header(const unsigned char *h, size_t len, DbfCtx *ctx, ColumnSpec **cols_out) {
+    memset(ctx, 0, sizeof(*ctx));
+    if (len < 32) {
+        fprintf(stderr, "dbf_parse_header: header curto (%zu bytes)\n", len);
+        return -1;
+    }
+
+    ctx->nrecords   = (int)(h[4] | (h[5] << 8) | (h[6] << 16) | ((unsigned)h[7] << 24));
+    ctx->header_len = read_u16_le(&h[8]);
+    ctx->record_len = read_u16_le(&h[10]);
+    if (ctx->nrecords < 0 || (size_t)ctx->header_len > len || ctx->header_len < 33) {
+        fprintf(stderr, "dbf_parse_header: header inválido (header_len=%ld, registros=%d)\n",
+                ctx->header_len, ctx->nrecords);
+        return -2;
+    }
+
+    /* descritores de 32 bytes a partir do offset 32, até 0x0D (terminador) */
+    int maxf = (int)((ctx->header_len - 32) / 32);
+    ColumnSpec *cols = (ColumnSpec*)calloc((size_t)(maxf ? maxf : 1), sizeof(ColumnSpec));
+    if (!cols) return -4;
+
+    int offset = 1; /* byte 0 do registro é a flag de deletado */
+    int nf = 0;
+    for (; nf < maxf; nf++) {
+        const unsigned char *fd = h + 32 + 32 * nf;
+        if (fd[0] == 0x0D) break;
+
+        ColumnSpec *c = &cols[nf];
+        memcpy(c->name, fd, 11);
+        c->name[11] = '\0';
+        c->type = (char)fd[11];
+        /* como o shapelib: só N/F têm casas decimais; nos demais o byte 17 é a
+           parte alta da largura (campos C > 255) */
+        if (c->type == 'N' || c->type == 'F') {
+            c->width    = fd[16];
+            c->decimals = fd[17];
+        } else {
+            c->width    = fd[16] + 256 * fd[17];
+            c->decimals = 0;
+        }
+        c->offset = offset;
+        offset += c->width;
+        c->kind = kind_for(field_type_for(c->type, c->width, c->decimals), c->decimals);
+    }
+    ctx->nfields = nf;
+
+    if (offset > ctx->record_len) {
+        fprintf(stderr, "dbf_parse_header: campos somam %d bytes, registro tem %ld\n", offset, ctx->record_len);
+        free(cols);
+        return -5;
+    }
+
+    *cols_out = cols;
+    return 0;
+}
+
+int dbf_read_header(const char *path, DbfCtx *ctx, ColumnSpec **cols_out) {
+    FILE *in = fopen(path, "rb");
+    if (!in) {
+        fprintf(stderr, "dbf_read_header: fopen('%s') falhou: %s\n", path, strerror(errno));
+        return -1;
+    }
+
+    /* tamanho do header em u16 LE no offset 8 */
+    unsigned char h32[32];
+    if (fread(h32, 1, sizeof(h32), in) != sizeof(h32)) {
+        fprintf(stderr, "dbf_read_header: header curto em '%s'\n", path);
+        fclose(in);
+        return -2;
+    }
+    size_t header_len = (size_t)read_u16_le(&h32[8]);
+    if (header_len < sizeof(h32)) {
+        fprintf(stderr, "dbf_read_header: header_len inválido (%zu) em '%s'\n", header_len, path);
+        fclose(in);
+        return -2;
+    }
+    unsigned char *header = (unsigned char*)malloc(header_len);
+    if (!header) { fclose(in); return -3; }
+    memcpy(header, h32, sizeof(h32));
+    size_t got = fread(header + sizeof(h32), 1, header_len - sizeof(h32), in);
+    fclose(in);
+    if (got != header_len - sizeof(h32)) {
+        fprintf(stderr, "dbf_read_header: header curto em '%s'\n", path);
+        free(header);
+        return -2;
+    }
+    /* no .dbc o último byte do header não é o terminador 0x0D (ver dbc2dbf);
+       no .dbf ele já é 0x0D ou fica depois do terminador */
+    header[header_len - 1] = 0x0D;
+
+    int rc = dbf_parse_header(header, header_len, ctx, cols_out);
+    free(header);
+    return rc != 0 ? -4 : 0;
+}
+
 int dbf_open(const char *path, DbfCtx *ctx, ColumnSpec **cols_out) {
     memset(ctx, 0, sizeof(*ctx));
 
@@ -45,33 +303,39 @@ int dbf_open(const char *path, DbfCtx *ctx, ColumnSpec **cols_out) {
         return -1;
     }
 
-    /* também abre bruto para checar flag 'deleted' e offsets */
-    ctx->raw = fopen(path, "rb");
-    if (!ctx->raw) {
-        fprintf(stderr, "dbf_open: fopen('%s') falhou: %s\n", path, strerror(errno));
+    /* registros são lidos direto do arquivo mapeado */
+    if (map_file(path, ctx) != 0) {
         DBFClose(ctx->h);
         ctx->h = NULL;
         return -2;
     }
 
-    unsigned char h32[32];
-    if (fread(h32, 1, 32, ctx->raw) != 32) {
+    if (ctx->map_len < 32) {
         fprintf(stderr, "dbf_open: não consegui ler 32 bytes do header\n");
-        fclose(ctx->raw); ctx->raw = NULL;
-        DBFClose(ctx->h); ctx->h = NULL;
+        dbf_close(ctx);
         return -3;
     }
 
-    ctx->header_len = read_u16_le(&h32[8]);
-    ctx->record_len = read_u16_le(&h32[10]);
+    ctx->header_len = read_u16_le(&ctx->map[8]);
+    ctx->record_len = read_u16_le(&ctx->map[10]);
 
     ctx->nfields  = DBFGetFieldCount(ctx->h);
     ctx->nrecords = DBFGetRecordCount(ctx->h);
 
+    /* arquivo truncado: só expõe registros completos dentro do mapa */
+    size_t avail = ctx->map_len > (size_t)ctx->header_len ? ctx->map_len - (size_t)ctx->header_len : 0;
+    if (ctx->record_len > 0 && (size_t)ctx->nrecords > avail / (size_t)ctx->record_len) {
+        int n = (int)(avail / (size_t)ctx->record_len);
+        fprintf(stderr, "dbf_open: arquivo truncado: header diz %d registros, há %d completos\n",
+                ctx->nrecords, n);
+        ctx->nrecords = n;
+    }
+
     /* monta ColumnSpec */
     ColumnSpec *cols = (ColumnSpec*)calloc((size_t)ctx->nfields, sizeof(ColumnSpec));
     if (!cols) { dbf_close(ctx); return -4; }
 
+    int offset = 1; /* byte 0 do registro é a flag de deletado */
     for (int i = 0; i < ctx->nfields; i++) {
         char name[12]; int width = 0, decimals = 0;
         DBFFieldType t = DBFGetFieldInfo(ctx->h, i, name, &width, &decimals);
@@ -83,28 +347,18 @@ int dbf_open(const char *path, DbfCtx *ctx, ColumnSpec **cols_out) {
 
         cols[i].width    = width;
         cols[i].decimals = decimals;
+        cols[i].type     = DBFGetNativeFieldType(ctx->h, i);
+        cols[i].offset   = offset;
+        offset += width;
 
-        switch (t) {
-            case FTString:
-            case FTInvalid: /* defensivo */
-                cols[i].kind = COL_UTF8;    break;
-
-            case FTInteger:
-                cols[i].kind = COL_INT64;   break;
-
-            case FTDouble:
-                cols[i].kind = (decimals > 0 ? COL_FLOAT64 : COL_INT64);
-                break;
-
-            case FTLogical:
-                cols[i].kind = COL_BOOL;    break;
-
-            case FTDate:
-                cols[i].kind = COL_DATE32;  break;
+        cols[i].kind = kind_for(t, decimals);
+    }
 
-            default:
-                cols[i].kind = COL_UTF8;    break;
-        }
+    if (offset > ctx->record_len) {
+        fprintf(stderr, "dbf_open: campos somam %d bytes, registro tem %ld\n", offset, ctx->record_len);
+        free(cols);
+        dbf_close(ctx);
+        return -5;
     }
 
     *cols_out = cols;
@@ -114,103 +368,971 @@ int dbf_open(const char *path, DbfCtx *ctx, ColumnSpec **cols_out) {
 void dbf_close(DbfCtx *ctx) {
     if (!ctx) return;
     if (ctx->h)   { DBFClose(ctx->h); ctx->h = NULL; }
-    if (ctx->raw) { fclose(ctx->raw); ctx->raw = NULL; }
+    if (ctx->stream) { ctx->stream_ops->close(ctx->stream); ctx->stream = NULL; }
+    free(ctx->peek);
+    unmap_file(ctx);
     memset(ctx, 0, sizeof(*ctx));
 }
 
-int dbf_is_deleted(const DbfCtx *ctx, int row) {
-    if (!ctx || !ctx->raw || row < 0 || row >= ctx->nrecords) return -1;
-    long off = (long)ctx->header_len + ((long)row) * (long)ctx->record_len;
-    if (fseek(ctx->raw, off, SEEK_SET) != 0) return -1;
-    int c = fgetc(ctx->raw);
-    if (c == EOF) return -1;
-    /* '*' (0x2A) = deletado; ' ' (0x20) = ativo */
-    return (c == '*') ? 1 : 0;
+/* Lê e descarta os próximos `n` registros da stream. */
+static int dbf_skip_stream(DbfCtx *ctx, int n) {
+    const size_t rl = (size_t)ctx->record_len;
+    int step = n < 4096 ? n : 4096;
+    unsigned char *buf = (unsigned char*)malloc((size_t)step * rl);
+    if (!buf) return -1;
+    while (n > 0) {
+        int k = n < step ? n : step;
+        if (ctx->stream_ops->read(ctx->stream, buf, (size_t)k * rl) != 0) {
+            free(buf);
+            return -1;
+        }
+        ctx->next_row += k;
+        n -= k;
+    }
+    free(buf);
+    return 0;
+}
+
+int dbf_fetch(DbfCtx *ctx, int row, int n, DbfCtx *view, unsigned char **owned) {
+    *owned = NULL;
+    if (!ctx || row < 0 || n < 0 || n > ctx->nrecords - row) return -1;
+
+    if (!ctx->stream) {
+        /* arquivo mapeado: acesso direto, sem cópia */
+        *view = *ctx;
+        return 0;
+    }
+
+    /* stream: só avança (lotes pedidos em ordem; registros antes de `row`
+       ainda não lidos são descartados, ex. --resume); o começo pode já estar
+       em ctx->peek (dbf_sample) */
+    const size_t rl = (size_t)ctx->record_len;
+    int from_peek = 0;
+    if (ctx->peek && row < ctx->peek_rows)
+        from_peek = ctx->peek_rows - row < n ? ctx->peek_rows - row : n;
+    else if (row > ctx->next_row && dbf_skip_stream(ctx, row - ctx->next_row) != 0)
+        return -1;
+    else if (row != ctx->next_row) {
+        fprintf(stderr, "dbf_fetch: lote fora de ordem (registro %d, esperado %d)\n", row, ctx->next_row);
+        return -1;
+    }
+    if (from_peek < n && row + from_peek != ctx->next_row) {
+        fprintf(stderr, "dbf_fetch: lote fora de ordem (registro %d, esperado %d)\n",
+                row + from_peek, ctx->next_row);
+        return -1;
+    }
+    size_t bytes = (size_t)n * rl;
+    unsigned char *buf = (unsigned char*)malloc(bytes ? bytes : 1);
+    if (!buf) return -1;
+    if (from_peek) memcpy(buf, ctx->peek + (size_t)row * rl, (size_t)from_peek * rl);
+    size_t rest = (size_t)(n - from_peek) * rl;
+    if (rest && ctx->stream_ops->read(ctx->stream, buf + (size_t)from_peek * rl, rest) != 0) {
+        free(buf);
+        return -1;
+    }
+    if (row + n > ctx->next_row) ctx->next_row = row + n;
+    if (ctx->peek && row + from_peek >= ctx->peek_rows) {
+        /* amostra já entregue */
+        free(ctx->peek);
+        ctx->peek = NULL;
+        ctx->peek_rows = 0;
+    }
+
+    /* visão só com estes registros: dbf_record(view, row) = buf */
+    memset(view, 0, sizeof(*view));
+    view->nfields    = ctx->nfields;
+    view->nrecords   = row + n;
+    view->record_len = ctx->record_len;
+    view->base_row   = row;
+    view->map        = buf;
+    view->map_len    = bytes;
+    *owned = buf;
+    return 0;
+}
+
+int dbf_sample(DbfCtx *ctx, int n, DbfCtx *view) {
+    if (!ctx || n < 0) return -1;
+    if (n > ctx->nrecords) n = ctx->nrecords;
+    if (!ctx->stream) {
+        *view = *ctx;
+        view->nrecords = n;
+        return 0;
+    }
+
+    if (!ctx->peek) {
+        if (ctx->next_row != 0) return -1;
+        size_t bytes = (size_t)n * (size_t)ctx->record_len;
+        ctx->peek = (unsigned char*)malloc(bytes ? bytes : 1);
+        if (!ctx->peek) return -1;
+        if (bytes && ctx->stream_ops->read(ctx->stream, ctx->peek, bytes) != 0) {
+            free(ctx->peek);
+            ctx->peek = NULL;
+            return -1;
+        }
+        ctx->peek_rows = n;
+        ctx->next_row = n;
+    }
+    if (n > ctx->peek_rows) n = ctx->peek_rows;
+
+    memset(view, 0, sizeof(*view));
+    view->nfields    = ctx->nfields;
+    view->nrecords   = n;
+    view->record_len = ctx->record_len;
+    view->map        = ctx->peek;
+    view->map_len    = (size_t)n * (size_t)ctx->record_len;
+    return 0;
+}
+
+void dbf_prefetch(const DbfCtx *ctx, int row, int n) {
+#ifdef _WIN32
+    (void)ctx; (void)row; (void)n; /* FILE_FLAG_SEQUENTIAL_SCAN já cobre o readahead */
+#else
+    if (!ctx || !ctx->map || row < ctx->base_row || n <= 0 || row >= ctx->nrecords) return;
+    if (n > ctx->nrecords - row) n = ctx->nrecords - row;
+    /* madvise exige endereço alinhado à página */
+    size_t page  = (size_t)sysconf(_SC_PAGESIZE);
+    size_t start = (size_t)(dbf_record(ctx, row) - ctx->map);
+    size_t end   = start + (size_t)n * (size_t)ctx->record_len;
+    start &= ~(page - 1);
+    posix_madvise((void*)(ctx->map + start), end - start, POSIX_MADV_WILLNEED);
+#endif
+}
+
+/* Conta as flags '*' em [row, row + n): gather com stride de registro, 8 por vez
+   com AVX2; escalar (branchless) no resto ou sem AVX2. */
+static int count_deleted(const DbfCtx *ctx, int row, int n) {
+    const unsigned char *p = dbf_record(ctx, row);
+    const size_t rl = (size_t)ctx->record_len;
+    int ndel = 0, i = 0;
+#if defined(__AVX2__)
+    /* gather lê 4 bytes por registro: para o último registro do grupo não
+       passar do fim do mapa, só vetoriza enquanto há folga */
+    const unsigned char *end = ctx->map + ctx->map_len;
+    if (rl <= (size_t)INT32_MAX / 8) {
+        const __m256i idx  = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7),
+                                                _mm256_set1_epi32((int)rl));
+        const __m256i mask = _mm256_set1_epi32(0xFF);
+        const __m256i star = _mm256_set1_epi32('*');
+        for (; i + 8 <= n && p + 7 * rl + 4 <= end; i += 8, p += 8 * rl) {
+            __m256i v  = _mm256_i32gather_epi32((const int*)p, idx, 1);
+            __m256i eq = _mm256_cmpeq_epi32(_mm256_and_si256(v, mask), star);
+            ndel += __builtin_popcount((unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(eq)));
+        }
+    }
+#endif
+    for (; i + 4 <= n; i += 4, p += 4 * rl)
+        ndel += (p[0] == '*') + (p[rl] == '*') + (p[2 * rl] == '*') + (p[3 * rl] == '*');
+    for (; i < n; i++, p += rl)
+        ndel += (p[0] == '*');
+    return ndel;
+}
+
+int dbf_scan_deleted(const DbfCtx *ctx, int row, int n, int *sel) {
+    if (!ctx || !ctx->map || row < ctx->base_row || n < 0 || n > ctx->nrecords - row) return -1;
+    if (n == 0) return 0;
+
+    /* passe 1: só conta — lote todo ativo (caso comum) sai sem montar seleção */
+    int ndel = count_deleted(ctx, row, n);
+    if (ndel == 0) return 0;
+
+    /* passe 2: índices dos ativos, sem desvio por registro */
+    const unsigned char *p = dbf_record(ctx, row);
+    const size_t rl = (size_t)ctx->record_len;
+    int k = 0;
+    for (int i = 0; i < n; i++, p += rl) {
+        sel[k] = i;
+        k += (p[0] != '*');
+    }
+    return ndel;
+}
+
+/* Bytes do campo direto no registro mapeado, recortados como o shapelib faz
+   ao ler string: para no 1º NUL, tira espaços à esquerda e à direita. */
+static inline const char* field_bytes(const unsigned char *rec, const ColumnSpec *col, size_t *out_len) {
+    const char *p = (const char*)rec + col->offset;
+    size_t len = (size_t)col->width;
+    const char *nul = memchr(p, '\0', len);
+    if (nul) len = (size_t)(nul - p);
+    len = enc_rtrim_len(p, len);
+    while (len > 0 && *p == ' ') { p++; len--; }
+    *out_len = len;
+    return p;
+}
+
+static const char* field_trimmed(const DbfCtx *ctx, const ColumnSpec *col, int row, size_t *out_len) {
+    return field_bytes(dbf_record(ctx, row), col, out_len);
+}
+
+/* Mesmas regras de DBFIsAttributeNULL() do shapelib, sobre o campo já recortado */
+static inline int field_is_null(char type, const char *p, size_t len) {
+    if (len == 0) return 1;
+    switch (type) {
+        case 'N':
+        case 'F': return p[0] == '*';                      /* "****" = NULL */
+        case 'D': return (len >= 8 && memcmp(p, "00000000", 8) == 0) ||
+                         (len == 1 && p[0] == '0');
+        case 'L': return p[0] == '?';
+        default:  return 0;
+    }
+}
+
+/* strtod sobre cópia terminada em NUL (campos numéricos têm no máx. 255 bytes).
+   Retorna 0 se o campo inteiro é um número, -1 se sobra lixo. */
+static int field_strtod(const char *p, size_t len, double *out) {
+    char buf[256];
+    if (len >= sizeof(buf)) return -1;
+    memcpy(buf, p, len);
+    buf[len] = '\0';
+    char *end = NULL;
+    *out = strtod(buf, &end);
+    return (end == buf + len) ? 0 : -1;
+}
+
+/* --- parser numérico de largura fixa ---
+   Campos N/F são texto "[+-]ddd[.ddd]" alinhado à direita. Em vez de strtod
+   por célula, os dígitos são acumulados num inteiro de 64 bits, 8 por vez
+   (SWAR) enquanto houver 8 dígitos seguidos, e o ponto vira uma escala. */
+
+#if defined(_WIN32) || (defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#define DBF_SWAR_DIGITS 1
+#endif
+
+#ifdef DBF_SWAR_DIGITS
+/* 1 se os 8 bytes (little-endian) são todos '0'..'9' */
+static inline int swar_is_8digits(uint64_t v) {
+    return (((v & 0xF0F0F0F0F0F0F0F0ULL) |
+             (((v + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4)) == 0x3333333333333333ULL);
+}
+
+/* Valor dos 8 dígitos ASCII (o 1º byte é o mais significativo) */
+static inline uint32_t swar_parse_8digits(uint64_t v) {
+    const uint64_t mask = 0x000000FF000000FFULL;
+    const uint64_t mul1 = 100 + (1000000ULL << 32);
+    const uint64_t mul2 = 1 + (10000ULL << 32);
+    v -= 0x3030303030303030ULL;
+    v = (v * 10) + (v >> 8);   /* pares de dígitos */
+    v = (((v & mask) * mul1) + (((v >> 16) & mask) * mul2)) >> 32;
+    return (uint32_t)v;
+}
+#endif
+
+/* 8 dígitos ASCII em s[0..8) → valor (0 ok); -1 se algum não é dígito */
+static inline int parse_8digits(const char *s, uint32_t *out) {
+#ifdef DBF_SWAR_DIGITS
+    uint64_t v;
+    memcpy(&v, s, 8);
+    if (!swar_is_8digits(v)) return -1;
+    *out = swar_parse_8digits(v);
+#else
+    uint32_t n = 0;
+    for (int i = 0; i < 8; i++) {
+        unsigned d = (unsigned)(s[i] - '0');
+        if (d > 9) return -1;
+        n = n * 10 + d;
+    }
+    *out = n;
+#endif
+    return 0;
+}
+
+/* Dias antes do dia 1 de cada mês (ano comum / bissexto) */
+static const int16_t days_before_month[2][13] = {
+    { 0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334, 365 },
+    { 0, 31, 60, 91, 121, 152, 182, 213, 244, 274, 305, 335, 366 }
+};
+
+/* "YYYYMMDD" → dias desde 1970-01-01, validando mês e dia do mês
+   ("00000000", 31/04, 29/02 fora de ano bissexto etc. → -1).
+   `s` aponta para dentro do registro (sem NUL): o chamador garante 8 bytes. */
+static inline int yyyymmdd_to_days(const char *s, int32_t *out_days) {
+    uint32_t n;
+    if (parse_8digits(s, &n) != 0) return -1;
+    int y = (int)(n / 10000), m = (int)(n / 100 % 100), d = (int)(n % 100);
+    int leap = (y % 4 == 0) & ((y % 100 != 0) | (y % 400 == 0));
+    if (y == 0 || (unsigned)(m - 1) > 11 || d < 1 ||
+        d > days_before_month[leap][m] - days_before_month[leap][m - 1]) return -1;
+
+    /* 477 = bissextos de 1 a 1969 */
+    int y1 = y - 1;
+    *out_days = (int32_t)(365 * (y - 1970) + (y1 / 4 - y1 / 100 + y1 / 400 - 477) +
+                          days_before_month[leap][m - 1] + d - 1);
+    return 0;
+}
+
+/* Acumula os dígitos de p[*i..len) em *mant (*nd = dígitos significativos,
+   *count += dígitos lidos). Para no 1º não-dígito. Retorna -1 se passar de
+   19 dígitos significativos (não cabe com folga em uint64). */
+static inline int scan_digits(const char *p, size_t len, size_t *i, uint64_t *mant, int *nd, int *count) {
+    size_t j = *i;
+    uint64_t m = *mant;
+    int n = *nd;
+    /* zeros à esquerda não contam para o limite de 19 dígitos */
+    if (n == 0) while (j < len && p[j] == '0') j++;
+#ifdef DBF_SWAR_DIGITS
+    while (j + 8 <= len) {
+        uint64_t v;
+        memcpy(&v, p + j, 8);
+        if (!swar_is_8digits(v)) break;
+        if (n + 8 > 19) return -1;
+        m = m * 100000000ULL + swar_parse_8digits(v);
+        n = m ? n + 8 : 0;
+        j += 8;
+    }
+#endif
+    for (; j < len && (unsigned)(p[j] - '0') < 10; j++) {
+        if (n + 1 > 19) return -1;
+        m = m * 10 + (uint64_t)(p[j] - '0');
+        if (m) n++;
+    }
+    *count += (int)(j - *i);
+    *i = j;
+    *mant = m;
+    *nd = n;
+    return 0;
+}
+
+/* "[+-]ddd[.ddd]" ocupando o campo inteiro (já recortado) → sinal, até 19
+   dígitos em *mant e nº de casas depois do ponto em *scale. Com frac == 0 a
+   fração só é validada (scale = 0: parte inteira truncada). Retorna 0 ok;
+   -1 fora desse formato (expoente, lixo, sem dígitos, > 19 dígitos). */
+static int scan_decimal(const char *p, size_t len, int frac, int *neg, uint64_t *mant, int *scale) {
+    size_t i = 0;
+    *neg = 0;
+    if (i < len && (p[i] == '-' || p[i] == '+')) { *neg = p[i] == '-'; i++; }
+
+    uint64_t m = 0;
+    int nd = 0, nint = 0, nfrac = 0;
+    if (scan_digits(p, len, &i, &m, &nd, &nint) != 0) return -1;
+    if (i < len && p[i] == '.') {
+        i++;
+        if (frac) {
+            /* zeros pulados na fração ainda contam em nfrac (escala) */
+            if (scan_digits(p, len, &i, &m, &nd, &nfrac) != 0) return -1;
+        } else {
+            size_t j = i;
+            while (j < len && (unsigned)(p[j] - '0') < 10) j++;
+            nfrac = (int)(j - i);
+            i = j;
+        }
+    }
+    if (i != len || nint + nfrac == 0) return -1;
+    *mant  = m;
+    *scale = frac ? nfrac : 0;
+    return 0;
+}
+
+static const double pow10_exact[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/* Campo N/F → int64 exato (casas decimais truncadas, como o cast de double).
+   Retorna 0 ok; -1 se o campo não é um número (tratado como NULL). */
+static int field_to_int64(const char *p, size_t len, int64_t *out) {
+    int neg, scale;
+    uint64_t m;
+    if (scan_decimal(p, len, 0, &neg, &m, &scale) == 0) {
+        if (m <= (uint64_t)INT64_MAX) {
+            *out = neg ? -(int64_t)m : (int64_t)m;
+            return 0;
+        }
+        if (neg && m == (uint64_t)INT64_MAX + 1) {
+            *out = INT64_MIN;
+            return 0;
+        }
+    }
+    /* expoente, > 19 dígitos ou fora do int64: strtod, como antes */
+    double d;
+    if (field_strtod(p, len, &d) != 0 || !(d >= -9223372036854775808.0 && d < 9223372036854775808.0))
+        return -1;
+    *out = (int64_t)d;
+    return 0;
+}
+
+static const uint64_t pow10_u64[] = {
+    1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL,
+    100000000ULL, 1000000000ULL, 10000000000ULL, 100000000000ULL, 1000000000000ULL,
+    10000000000000ULL, 100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL,
+    100000000000000000ULL, 1000000000000000000ULL, 10000000000000000000ULL
+};
+
+/* a * b → 128 bits (*hi, retorno = parte baixa) */
+static inline uint64_t mul_u64(uint64_t a, uint64_t b, uint64_t *hi) {
+#ifdef __SIZEOF_INT128__
+    unsigned __int128 r = (unsigned __int128)a * b;
+    *hi = (uint64_t)(r >> 64);
+    return (uint64_t)r;
+#else
+    uint64_t a0 = a & 0xFFFFFFFFu, a1 = a >> 32, b0 = b & 0xFFFFFFFFu, b1 = b >> 32;
+    uint64_t p00 = a0 * b0, p01 = a0 * b1, p10 = a1 * b0, p11 = a1 * b1;
+    uint64_t mid = (p00 >> 32) + (p01 & 0xFFFFFFFFu) + (p10 & 0xFFFFFFFFu);
+    *hi = p11 + (p01 >> 32) + (p10 >> 32) + (mid >> 32);
+    return (mid << 32) | (p00 & 0xFFFFFFFFu);
+#endif
+}
+
+/* Campo N → decimal128 com `scale` casas, direto dos dígitos (sem double):
+   "-12.5" com scale 2 → -1250. Casas além de `scale` são truncadas.
+   Escreve lo/hi (complemento de 2). Retorna 0 ok; -1 se não é um número;
+   -2 se o valor passa de `precision` dígitos (ex.: "123456789" sem ponto num
+   N(9,2)): o writer Parquet dimensiona os bytes pela precisão. */
+static int field_to_dec128(const char *p, size_t len, int precision, int scale,
+                           uint64_t *lo, uint64_t *hi) {
+    int neg, s;
+    uint64_t m;
+    if (scan_decimal(p, len, 1, &neg, &m, &s) != 0) return -1;
+
+    uint64_t l = m, h = 0;
+    if (s > scale) {
+        l = s - scale > 19 ? 0 : l / pow10_u64[s - scale];
+    } else {
+        while (s < scale) {
+            int k = scale - s > 19 ? 19 : scale - s;
+            uint64_t carry;
+            l = mul_u64(l, pow10_u64[k], &carry);
+            h = h * pow10_u64[k] + carry;
+            s += k;
+        }
+    }
+
+    /* |valor| < 10^precision (10^20..10^38 em 128 bits) */
+    uint64_t lim_lo, lim_hi = 0;
+    if (precision <= 19) lim_lo = pow10_u64[precision];
+    else lim_lo = mul_u64(pow10_u64[19], pow10_u64[precision - 19], &lim_hi);
+    if (h > lim_hi || (h == lim_hi && l >= lim_lo)) return -2;
+
+    if (neg) {
+        l = ~l + 1;
+        h = ~h + (l == 0);
+    }
+    *lo = l;
+    *hi = h;
+    return 0;
+}
+
+/* Campo N/F → double. Mantissa até 2^53 e até 22 casas: uma divisão exata,
+   com o mesmo arredondamento do strtod; fora disso, strtod.
+   Retorna 0 ok; -1 se o campo não é um número (tratado como NULL). */
+static int field_to_f64(const char *p, size_t len, double *out) {
+    int neg, scale;
+    uint64_t m;
+    if (scan_decimal(p, len, 1, &neg, &m, &scale) == 0 &&
+        m <= (1ULL << 53) && scale <= 22) {
+        double d = (double)m / pow10_exact[scale];
+        *out = neg ? -d : d;
+        return 0;
+    }
+    return field_strtod(p, len, out);
+}
+
+const char* dbf_field(const unsigned char *rec, const ColumnSpec *col, size_t *len) {
+    return field_bytes(rec, col, len);
+}
+
+int dbf_field_is_null(const ColumnSpec *col, const char *p, size_t len) {
+    return field_is_null(col->type, p, len);
+}
+
+int dbf_parse_f64(const char *p, size_t len, double *out) {
+    return field_to_f64(p, len, out);
+}
+
+static inline int field_bool(const char *p) {
+    char c = (char)toupper((unsigned char)p[0]);
+    return (c == 'Y' || c == 'T' || c == '1') ? 1 : 0;
+}
+
+/* --- decodificador colunar --- */
+
+void colbuf_free(ColBuf *b) {
+    if (!b) return;
+    free(b->validity);
+    free(b->values);
+    free(b->data);
+    free(b->dict_offsets);
+    memset(b, 0, sizeof(*b));
+}
+
+static int data_reserve(ColBuf *b, size_t extra) {
+    size_t need = b->data_len + extra;
+    if (need <= b->data_cap) return 0;
+    size_t cap = b->data_cap ? b->data_cap : 4096;
+    while (cap < need) cap *= 2;
+    char *tmp = (char*)realloc(b->data, cap);
+    if (!tmp) return -1;
+    b->data = tmp;
+    b->data_cap = cap;
+    return 0;
 }
 
-/* parse "YYYYMMDD" -> days since 1970-01-01; retorna 0 em sucesso */
-static int yyyymmdd_to_days(const char *s, int *out_days) {
-    if (!s || strlen(s) < 8) return -1;
+#define BIT_SET(bm, i)   ((bm)[(i) >> 3] |= (unsigned char)(1u << ((i) & 7)))
 
-    char buf[9];
-    memcpy(buf, s, 8);
-    buf[8] = '\0';
+/* --- dicionário: bytes crus do campo → índice ---
+   Tabela de endereçamento aberto sobre os bytes (ainda na codepage de origem)
+   do registro; cada valor distinto é convertido para UTF-8 uma vez só. */
+typedef struct {
+    const char *key;     /* NULL = vazio; aponta para dentro do registro */
+    uint32_t    len;
+    uint32_t    hash;
+    int32_t     idx;
+} DictSlot;
 
-    int y = atoi(&buf[0]);
-    int m = atoi(&buf[4]);
-    int d = atoi(&buf[6]);
+typedef struct {
+    DictSlot *slots;
+    uint32_t  mask;
+    int       n;
+} DictTable;
 
-    if (y <= 0 || m < 1 || m > 12 || d < 1 || d > 31) return -1;
+static inline uint32_t dict_hash(const char *p, size_t len) {
+    uint32_t h = 2166136261u; /* FNV-1a */
+    for (size_t i = 0; i < len; i++) h = (h ^ (unsigned char)p[i]) * 16777619u;
+    return h;
+}
 
-    int a  = (14 - m) / 12;
-    int y1 = y + 4800 - a;
-    int m1 = m + 12 * a - 3;
+static int dict_init(DictTable *t, int expected) {
+    uint32_t cap = 64;
+    while (cap < (uint32_t)expected * 2 && cap < (1u << 20)) cap <<= 1;
+    t->slots = (DictSlot*)calloc(cap, sizeof(DictSlot));
+    t->mask = cap - 1;
+    t->n = 0;
+    return t->slots ? 0 : -1;
+}
 
-    long jdn = d + (153 * m1 + 2) / 5 + 365L * y1 + y1 / 4 - y1 / 100 + y1 / 400 - 32045;
-    *out_days = (int)(jdn - 2440588L); /* 1970-01-01 */
+static int dict_grow(DictTable *t) {
+    uint32_t cap = (t->mask + 1) * 2;
+    DictSlot *slots = (DictSlot*)calloc(cap, sizeof(DictSlot));
+    if (!slots) return -1;
+    for (uint32_t i = 0; i <= t->mask; i++) {
+        DictSlot *s = &t->slots[i];
+        if (!s->key) continue;
+        uint32_t j = s->hash & (cap - 1);
+        while (slots[j].key) j = (j + 1) & (cap - 1);
+        slots[j] = *s;
+    }
+    free(t->slots);
+    t->slots = slots;
+    t->mask = cap - 1;
     return 0;
 }
 
-int dbf_read_value(const DbfCtx *ctx, const ColumnSpec *col, int col_idx, int row,
-                   const char *from_cp, int strict,
-                   char **out_str, long long *out_i64, double *out_f64, int *out_bool, int *out_i32)
+/* Slot do valor (novo: idx = -1, o chamador preenche). NULL sem memória. */
+static DictSlot* dict_lookup(DictTable *t, const char *p, size_t len) {
+    uint32_t h = dict_hash(p, len);
+    uint32_t j = h & t->mask;
+    for (;;) {
+        DictSlot *s = &t->slots[j];
+        if (!s->key) break;
+        if (s->hash == h && s->len == len && memcmp(s->key, p, len) == 0) return s;
+        j = (j + 1) & t->mask;
+    }
+    if ((uint32_t)(t->n + 1) * 2 > t->mask + 1) {
+        if (dict_grow(t) != 0) return NULL;
+        return dict_lookup(t, p, len);
+    }
+    DictSlot *s = &t->slots[j];
+    s->key  = p;
+    s->len  = (uint32_t)len;
+    s->hash = h;
+    s->idx  = -1;
+    t->n++;
+    return s;
+}
+
+int dbf_count_distinct(const DbfCtx *ctx, const ColumnSpec *col, int row, int n,
+                       int limit, int *nonnull) {
+    *nonnull = 0;
+    if (!ctx || !col || row < ctx->base_row || n < 0 || n > ctx->nrecords - row) return -1;
+    if (col->offset < 0) {
+        *nonnull = col->value ? n : 0;
+        return col->value && n > 0 ? 1 : 0;
+    }
+    if (n == 0) return 0;
+    if (!ctx->map) return -1;
+
+    DictTable t;
+    if (dict_init(&t, limit < n ? limit : n) != 0) return -1;
+    const unsigned char *rec = dbf_record(ctx, row);
+    for (int i = 0; i < n && t.n < limit; i++, rec += ctx->record_len) {
+        size_t len;
+        const char *p = field_bytes(rec, col, &len);
+        if (field_is_null(col->type, p, len)) continue;
+        (*nonnull)++;
+        if (!dict_lookup(&t, p, len)) { free(t.slots); return -1; }
+    }
+    int distinct = t.n;
+    free(t.slots);
+    return distinct;
+}
+
+long long dbf_text_bytes(const DbfCtx *ctx, const ColumnSpec *col, int row, int n, int *nonnull) {
+    *nonnull = 0;
+    if (!ctx || !col || row < ctx->base_row || n < 0 || n > ctx->nrecords - row) return -1;
+    if (col->offset < 0) {
+        if (!col->value) return 0;
+        *nonnull = n;
+        return (long long)strlen(col->value) * n;
+    }
+    if (n == 0) return 0;
+    if (!ctx->map) return -1;
+
+    long long total = 0;
+    const unsigned char *rec = dbf_record(ctx, row);
+    for (int i = 0; i < n; i++, rec += ctx->record_len) {
+        size_t len;
+        const char *p = field_bytes(rec, col, &len);
+        if (field_is_null(col->type, p, len)) continue;
+        (*nonnull)++;
+        total += (long long)len;
+    }
+    return total;
+}
+
+int dbf_int_range(const DbfCtx *ctx, const ColumnSpec *col, int row, int n,
+                  int64_t *min, int64_t *max, int *nonnull) {
+    *nonnull = 0;
+    *min = *max = 0;
+    if (!ctx || !col || row < ctx->base_row || n < 0 || n > ctx->nrecords - row) return -1;
+    if (col->offset < 0 || n == 0) return 0;
+    if (!ctx->map) return -1;
+
+    const unsigned char *rec = dbf_record(ctx, row);
+    for (int i = 0; i < n; i++, rec += ctx->record_len) {
+        size_t len;
+        int64_t v;
+        const char *p = field_bytes(rec, col, &len);
+        if (field_is_null(col->type, p, len) || field_to_int64(p, len, &v) != 0) continue;
+        if (*nonnull == 0 || v < *min) *min = v;
+        if (*nonnull == 0 || v > *max) *max = v;
+        (*nonnull)++;
+    }
+    return 0;
+}
+
+static int dict_reserve(ColBuf *b) {
+    if (b->ndict + 2 <= b->dict_cap) return 0;
+    int cap = b->dict_cap ? b->dict_cap * 2 : 256;
+    int32_t *tmp = (int32_t*)realloc(b->dict_offsets, (size_t)cap * sizeof(int32_t));
+    if (!tmp) return -1;
+    b->dict_offsets = tmp;
+    b->dict_cap = cap;
+    return 0;
+}
+
+/* Acrescenta ao dicionário de `b` o valor UTF-8 de p[0..len) (já convertido
+   se enc == NULL). Retorna o índice; -1 erro de conversão; -2 sem memória. */
+static int dict_append(ColBuf *b, const char *p, size_t len, EncCtx *enc, int strict) {
+    if (dict_reserve(b) != 0) return -2;
+    if (b->ndict == 0) b->dict_offsets[0] = 0;
+    size_t outlen = len;
+    if (enc) {
+        if (data_reserve(b, enc_utf8_bound(enc, len)) != 0) return -2;
+        int rc = enc_convert(enc, p, len, b->data + b->data_len, &outlen, strict);
+        if (rc != 0) return rc == -2 ? -1 : -2;
+    } else {
+        if (data_reserve(b, len) != 0) return -2;
+        memcpy(b->data + b->data_len, p, len);
+    }
+    b->data_len += outlen;
+    if (b->data_len > (size_t)INT32_MAX) return -2;
+    b->dict_offsets[++b->ndict] = (int32_t)b->data_len;
+    return b->ndict - 1;
+}
+
+/* COL_UTF8 com dict: índices int32 em out->values, valores distintos em
+   out->data/dict_offsets (na ordem da 1ª ocorrência no lote) */
+static int decode_dict(const unsigned char *base, size_t rl, const ColumnSpec *col,
+                       int row, const int *sel, int nsel, EncCtx *enc, int strict,
+                       ColBuf *out, int *err_row) {
+    int32_t *idx = (int32_t*)out->values;
+    unsigned char *valid = out->validity;
+    if (dict_reserve(out) != 0 || data_reserve(out, 1) != 0) return -2;
+    out->dict_offsets[0] = 0;
+
+    if (col->offset < 0) {
+        /* valor constante: dicionário de 1 entrada; sem valor: tudo nulo */
+        if (col->value && nsel > 0) {
+            if (dict_append(out, col->value, strlen(col->value), NULL, 0) < 0) return -2;
+            free(out->validity);
+            out->validity = NULL;
+        } else {
+            out->nnulls = nsel;
+        }
+        return 0;
+    }
+
+    DictTable t;
+    if (dict_init(&t, nsel < 1024 ? nsel : 1024) != 0) return -2;
+    long long nnulls = 0;
+    int rc = 0;
+    for (int k = 0; k < nsel; k++) {
+        const unsigned char *rec = base + (size_t)(sel ? sel[k] : k) * rl;
+        size_t len;
+        const char *p = field_bytes(rec, col, &len);
+        if (field_is_null(col->type, p, len)) { nnulls++; continue; }
+        DictSlot *s = dict_lookup(&t, p, len);
+        if (!s) { rc = -2; break; }
+        if (s->idx < 0) {
+            int i = dict_append(out, p, len, enc, strict);
+            if (i < 0) {
+                if (i == -1 && err_row) *err_row = row + (sel ? sel[k] : k);
+                rc = i;
+                break;
+            }
+            s->idx = i;
+        }
+        idx[k] = s->idx;
+        BIT_SET(valid, k);
+    }
+    free(t.slots);
+    out->nnulls = nnulls;
+    return rc;
+}
+
+int dbf_decode_column(const DbfCtx *ctx, const ColumnSpec *col,
+                      int row, const int *sel, int nsel,
+                      EncCtx *enc, int strict,
+                      ColBuf *out, int *err_row)
 {
-    if (!ctx || !col) return -1;
+    memset(out, 0, sizeof(*out));
+    if (!ctx || !col || !ctx->map || nsel < 0) return -2;
+
+    size_t bm_len = ((size_t)nsel + 7) / 8;
+    size_t vsize;
+    switch (col->kind) {
+        case COL_UTF8:    vsize = ((size_t)nsel + (col->dict ? 0 : 1)) * sizeof(int32_t); break;
+        case COL_BOOL:    vsize = bm_len;                               break;
+        case COL_INT8:    vsize = (size_t)nsel * sizeof(int8_t);        break;
+        case COL_INT16:   vsize = (size_t)nsel * sizeof(int16_t);       break;
+        case COL_INT32:   vsize = (size_t)nsel * sizeof(int32_t);       break;
+        case COL_INT64:   vsize = (size_t)nsel * sizeof(int64_t);       break;
+        case COL_FLOAT64: vsize = (size_t)nsel * sizeof(double);        break;
+        case COL_DATE32:  vsize = (size_t)nsel * sizeof(int32_t);       break;
+        case COL_DECIMAL128: vsize = (size_t)nsel * 16;                 break;
+        default:          return -2;
+    }
 
-    if (DBFIsAttributeNULL(ctx->h, row, col_idx)) return 1;
+    /* calloc: slots nulos ficam zerados e bits começam em 0 */
+    out->nrows      = nsel;
+    out->validity   = (unsigned char*)calloc(bm_len ? bm_len : 1, 1);
+    out->values     = calloc(vsize ? vsize : 1, 1);
+    out->values_len = vsize;
+    if (!out->validity || !out->values) { colbuf_free(out); return -2; }
 
+    if (col->kind == COL_UTF8 && col->dict) {
+        int rc = decode_dict(col->offset < 0 ? NULL : dbf_record(ctx, row), (size_t)ctx->record_len,
+                             col, row, sel, nsel, enc, strict, out, err_row);
+        if (rc != 0) { colbuf_free(out); return rc; }
+        if (out->nnulls == 0) { free(out->validity); out->validity = NULL; }
+        return 0;
+    }
+
+    /* coluna extra: valor constante ou toda nula, sem olhar o registro */
+    if (col->offset < 0) {
+        if (col->value && col->kind == COL_UTF8) {
+            size_t len = strlen(col->value);
+            if ((size_t)nsel * len > (size_t)INT32_MAX ||
+                data_reserve(out, (size_t)nsel * len + 1) != 0) { colbuf_free(out); return -2; }
+            int32_t *offs = (int32_t*)out->values;
+            for (int k = 0; k < nsel; k++) {
+                memcpy(out->data + out->data_len, col->value, len);
+                out->data_len += len;
+                offs[k + 1] = (int32_t)out->data_len;
+            }
+            free(out->validity);
+            out->validity = NULL;
+        } else {
+            if (col->kind == COL_UTF8 && data_reserve(out, 1) != 0) { colbuf_free(out); return -2; }
+            out->nnulls = nsel;
+            if (nsel == 0) { free(out->validity); out->validity = NULL; }
+        }
+        return 0;
+    }
+
+    const unsigned char *base = dbf_record(ctx, row);
+    const size_t rl = (size_t)ctx->record_len;
+    unsigned char *valid = out->validity;
+    long long nnulls = 0;
+
+    /* um laço por tipo: o switch fica fora do laço de linhas */
     switch (col->kind) {
         case COL_UTF8: {
-            const char *raw = DBFReadStringAttribute(ctx->h, row, col_idx);
-            if (!raw || raw[0] == '\0') return 1;
-
-            size_t len = strlen(raw);
-            while (len > 0 && (unsigned char)raw[len - 1] <= ' ') len--;
-
-            char *utf8 = NULL;
-            size_t outlen = 0;
-            int rc = to_utf8(from_cp, raw, len, &utf8, &outlen, strict);
-            if (rc == -2) return -1; /* strict: falhou */
-            if (rc != 0) {
-                utf8 = (char*)malloc(len + 1);
-                if (!utf8) return -1;
-                memcpy(utf8, raw, len);
-                utf8[len] = '\0';
+            int32_t *offs = (int32_t*)out->values;
+            if (data_reserve(out, (size_t)nsel * (size_t)col->width + 16) != 0) { colbuf_free(out); return -2; }
+            for (int k = 0; k < nsel; k++) {
+                const unsigned char *rec = base + (size_t)(sel ? sel[k] : k) * rl;
+                size_t len;
+                const char *p = field_bytes(rec, col, &len);
+                if (field_is_null(col->type, p, len)) {
+                    nnulls++;
+                } else {
+                    size_t outlen = 0;
+                    if (data_reserve(out, enc_utf8_bound(enc, len)) != 0) { colbuf_free(out); return -2; }
+                    int rc = enc_convert(enc, p, len, out->data + out->data_len, &outlen, strict);
+                    if (rc != 0) {
+                        if (err_row) *err_row = row + (sel ? sel[k] : k);
+                        colbuf_free(out);
+                        return rc == -2 ? -1 : -2;
+                    }
+                    out->data_len += outlen;
+                    if (out->data_len > (size_t)INT32_MAX) { colbuf_free(out); return -2; }
+                    BIT_SET(valid, k);
+                }
+                offs[k + 1] = (int32_t)out->data_len;
             }
-            *out_str = utf8;
-            return 0;
+            break;
         }
 
         case COL_BOOL: {
-            const char *raw = DBFReadStringAttribute(ctx->h, row, col_idx);
-            if (!raw || raw[0] == '\0') return 1;
-            char c = (char)toupper((unsigned char)raw[0]);
-            *out_bool = (c == 'Y' || c == 'T' || c == '1') ? 1 : 0;
-            return 0;
+            unsigned char *bits = (unsigned char*)out->values;
+            for (int k = 0; k < nsel; k++) {
+                const unsigned char *rec = base + (size_t)(sel ? sel[k] : k) * rl;
+                size_t len;
+                const char *p = field_bytes(rec, col, &len);
+                if (field_is_null(col->type, p, len)) { nnulls++; continue; }
+                BIT_SET(valid, k);
+                if (field_bool(p)) BIT_SET(bits, k);
+            }
+            break;
         }
 
         case COL_INT64: {
-            int ival = DBFReadIntegerAttribute(ctx->h, row, col_idx);
-            *out_i64 = (long long)ival;
-            return 0;
+            int64_t *v = (int64_t*)out->values;
+            for (int k = 0; k < nsel; k++) {
+                const unsigned char *rec = base + (size_t)(sel ? sel[k] : k) * rl;
+                size_t len;
+                const char *p = field_bytes(rec, col, &len);
+                if (field_is_null(col->type, p, len) || field_to_int64(p, len, &v[k]) != 0) {
+                    v[k] = 0;
+                    nnulls++;
+                    continue;
+                }
+                BIT_SET(valid, k);
+            }
+            break;
         }
 
+        /* estreitados: mesmo parser. Valor fora da faixa da amostra (--infer
+           sample) é erro; num tipo pelo menos tão largo quanto o da largura
+           (--infer width, merge) o valor não cabe nos dígitos declarados
+           (expoente): campo malformado, NULL (erro com strict) */
+#define DECODE_NARROW(T, LO, HI)                                                        \
+        {                                                                               \
+            T *v = (T*)out->values;                                                     \
+            const int by_width = (int)sizeof(T) >= int_kind_bytes(dbf_width_int_kind(col)); \
+            for (int k = 0; k < nsel; k++) {                                            \
+                const unsigned char *rec = base + (size_t)(sel ? sel[k] : k) * rl;      \
+                size_t len;                                                             \
+                int64_t x;                                                              \
+                const char *p = field_bytes(rec, col, &len);                            \
+                if (field_is_null(col->type, p, len) || field_to_int64(p, len, &x) != 0) { \
+                    nnulls++;                                                           \
+                    continue;                                                           \
+                }                                                                       \
+                if (x < (LO) || x > (HI)) {                                             \
+                    if (by_width && !strict) {                                          \
+                        nnulls++;                                                       \
+                        continue;                                                       \
+                    }                                                                   \
+                    if (err_row) *err_row = row + (sel ? sel[k] : k);                   \
+                    colbuf_free(out);                                                   \
+                    return by_width ? -1 : -3;                                          \
+                }                                                                       \
+                v[k] = (T)x;                                                            \
+                BIT_SET(valid, k);                                                      \
+            }                                                                           \
+        }
+        case COL_INT8:  DECODE_NARROW(int8_t,  INT8_MIN,  INT8_MAX)  break;
+        case COL_INT16: DECODE_NARROW(int16_t, INT16_MIN, INT16_MAX) break;
+        case COL_INT32: DECODE_NARROW(int32_t, INT32_MIN, INT32_MAX) break;
+#undef DECODE_NARROW
+
         case COL_FLOAT64: {
-            double d = DBFReadDoubleAttribute(ctx->h, row, col_idx);
-            *out_f64 = d;
-            return 0;
+            double *v = (double*)out->values;
+            for (int k = 0; k < nsel; k++) {
+                const unsigned char *rec = base + (size_t)(sel ? sel[k] : k) * rl;
+                size_t len;
+                const char *p = field_bytes(rec, col, &len);
+                if (field_is_null(col->type, p, len) || field_to_f64(p, len, &v[k]) != 0) {
+                    v[k] = 0;
+                    nnulls++;
+                    continue;
+                }
+                BIT_SET(valid, k);
+            }
+            break;
+        }
+
+        case COL_DECIMAL128: {
+            uint64_t *v = (uint64_t*)out->values; /* lo, hi por linha */
+            const int precision = dbf_decimal_precision(col);
+            for (int k = 0; k < nsel; k++) {
+                const unsigned char *rec = base + (size_t)(sel ? sel[k] : k) * rl;
+                size_t len;
+                const char *p = field_bytes(rec, col, &len);
+                int drc = field_is_null(col->type, p, len) ? -1
+                        : field_to_dec128(p, len, precision, col->decimals, &v[2 * k], &v[2 * k + 1]);
+                if (drc == -2 && strict) {
+                    /* acima da precisão: NULL, ou erro com --encoding-strict */
+                    if (err_row) *err_row = row + (sel ? sel[k] : k);
+                    colbuf_free(out);
+                    return -1;
+                }
+                if (drc != 0) {
+                    v[2 * k] = v[2 * k + 1] = 0;
+                    nnulls++;
+                    continue;
+                }
+                BIT_SET(valid, k);
+            }
+            break;
         }
 
         case COL_DATE32: {
-            const char *raw = DBFReadStringAttribute(ctx->h, row, col_idx);
-            if (!raw || strlen(raw) < 8) return 1;
-            int days = 0;
-            if (yyyymmdd_to_days(raw, &days) != 0) return 1;
-            *out_i32 = days;
-            return 0;
+            int32_t *v = (int32_t*)out->values;
+            /* memo do último campo: datas costumam vir agrupadas (mesmo dia em
+               registros seguidos), e aí nem a conversão roda */
+            char memo_raw[8] = {0};
+            int32_t memo_days = 0;
+            int memo_ok = -1; /* -1 = vazio, 0 = NULL, 1 = válido */
+            const int direct = col->width == 8;
+            for (int k = 0; k < nsel; k++) {
+                const unsigned char *rec = base + (size_t)(sel ? sel[k] : k) * rl;
+                const char *raw = (const char*)rec + col->offset;
+                if (direct && memo_ok >= 0 && memcmp(raw, memo_raw, 8) == 0) {
+                    if (!memo_ok) { nnulls++; continue; }
+                    BIT_SET(valid, k);
+                    v[k] = memo_days;
+                    continue;
+                }
+
+                int32_t days = 0;
+                int ok;
+                if (direct && yyyymmdd_to_days(raw, &days) == 0) {
+                    ok = 1; /* caso comum: 8 dígitos, sem recorte */
+                } else {
+                    /* espaços, NUL, "0" ou campo mais largo: regras do shapelib */
+                    size_t len;
+                    const char *p = field_bytes(rec, col, &len);
+                    ok = !field_is_null(col->type, p, len) && len >= 8 &&
+                         yyyymmdd_to_days(p, &days) == 0;
+                }
+                if (direct) {
+                    memcpy(memo_raw, raw, 8);
+                    memo_days = days;
+                    memo_ok = ok;
+                }
+                if (!ok) { nnulls++; continue; }
+                BIT_SET(valid, k);
+                v[k] = days;
+            }
+            break;
         }
 
         default:
-            return 1;
+            break;
     }
+
+    out->nnulls = nnulls;
+    if (nnulls == 0) { free(out->validity); out->validity = NULL; }
+    return 0;
 }
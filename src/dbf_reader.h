@@ -2,7 +2,9 @@
 #define DBF_READER_H
 
 #include <stddef.h>
+#include <stdint.h>
 #include "shapefil.h"
+#include "encoding.h"
 
 /* Tipos normalizados para mapear para Arrow */
 typedef enum {
@@ -10,47 +12,197 @@ typedef enum {
     COL_BOOL,
     COL_INT64,
     COL_FLOAT64,
-    COL_DATE32
+    COL_DATE32,
+    COL_DECIMAL128,  /* N(w,d) com d > 0 como inteiro escalado (--decimal) */
+    COL_INT8,        /* inteiros estreitados pela largura/amostra (--infer) */
+    COL_INT16,
+    COL_INT32
 } ColKind;
 
+static inline int dbf_kind_is_int(ColKind k) {
+    return k == COL_INT8 || k == COL_INT16 || k == COL_INT32 || k == COL_INT64;
+}
+
 typedef struct {
-    char     name[12+1]; /* shapelib limita a 11 chars no DBF clássico */
+    char     name[64];   /* 11 chars no DBF clássico; mais só em colunas extras (--source-column) */
     ColKind  kind;
     int      width;
     int      decimals;
+    char     type;       /* tipo nativo do DBF ('C', 'N', 'F', 'D', 'L', 'M', ...) */
+    int      offset;     /* offset do campo dentro do registro (byte 0 = flag deleted);
+                            < 0 = coluna fora do registro (ver `value`) */
+    const char *value;   /* offset < 0: texto UTF-8 repetido em todas as linhas (COL_UTF8),
+                            ou NULL para coluna toda nula */
+    int      dict;       /* COL_UTF8: dictionary<int32, utf8> (--dictionary) */
+    int      precision;  /* COL_DECIMAL128: precisão do schema de saída quando não vem
+                            da largura (merge: largura do arquivo, precisão unificada);
+                            0 = pela largura */
 } ColumnSpec;
 
+/* --decimal: colunas N(w,d) com 0 < d < w <= 20 passam de COL_FLOAT64 para
+   COL_DECIMAL128 (até 19 dígitos: cabem no parser inteiro). F continua double. */
+void dbf_map_decimals(ColumnSpec *cols, int ncols);
+
+/* Tipo inteiro pela largura declarada de uma coluna COL_INT64: só campos N
+   (dígitos e sinal), w <= 2 → INT8, w <= 4 → INT16, w <= 9 → INT32; F (que
+   admite notação exponencial, "1.0E+10" num F(9,0)) e os demais → INT64. */
+ColKind dbf_width_int_kind(const ColumnSpec *col);
+
+/* --infer width: colunas COL_INT64 passam para dbf_width_int_kind(). Um valor
+   que mesmo assim não cabe (expoente num N) fica NULL na decodificação, sem
+   abortar o arquivo. */
+void dbf_narrow_ints(ColumnSpec *cols, int ncols);
+
+/* Menor tipo inteiro que comporta [min, max]. */
+ColKind dbf_int_kind_for_range(int64_t min, int64_t max);
+
+/* Precisão decimal128 de uma coluna COL_DECIMAL128: col->precision se dada,
+   senão pela largura, em que o ponto ocupa 1 dos `width` chars (no schema
+   unificado do merge, width = maior parte inteira + maior escala). */
+static inline int dbf_decimal_precision(const ColumnSpec *col) {
+    if (col->precision > 0) return col->precision;
+    int p = col->width - 1;
+    if (p > 38) p = 38;
+    if (p < col->decimals) p = col->decimals;
+    return p < 1 ? 1 : p;
+}
+
+/* Fonte sequencial de registros (ex.: .dbc descompactado em streaming) */
+typedef struct DbfStream DbfStream;
 typedef struct {
-    DBFHandle h;
+    int  (*read)(DbfStream *s, unsigned char *dst, size_t len); /* exatamente len bytes: 0 ok, -1 erro/fim */
+    void (*close)(DbfStream *s);
+} DbfStreamOps;
+
+typedef struct {
+    DBFHandle h;         /* shapelib: só cabeçalho e descritores de campo */
     int nfields;
     int nrecords;
 
-    /* Para flag "deleted": lemos do arquivo bruto (cabeçalho+registros) */
-    FILE *raw;
     long header_len;  /* bytes do cabeçalho */
     long record_len;  /* bytes por registro */
+
+    /* Arquivo inteiro mapeado em memória (somente leitura): os registros são
+       lidos direto do mapa, sem seek/cópia por célula */
+    const unsigned char *map;
+    size_t map_len;
+#ifdef _WIN32
+    void *map_file;      /* HANDLE do arquivo */
+    void *map_handle;    /* HANDLE do file mapping */
+#endif
+    int base_row;        /* registro que fica em map + header_len (visões de lote) */
+
+    /* Sem mapa: registros chegam em ordem por uma stream (ver dbf_fetch) */
+    DbfStream          *stream;
+    const DbfStreamOps *stream_ops;
+    int                 next_row;   /* próximo registro a ler da stream */
+    unsigned char      *peek;       /* registros [0, peek_rows) já lidos por dbf_sample() */
+    int                 peek_rows;
 } DbfCtx;
 
-/* Abre DBF e o arquivo bruto para checar deletados; detecta schema. */
+/* Abre DBF (cabeçalho via shapelib) e mapeia o arquivo em memória; detecta schema. */
 int dbf_open(const char *path, DbfCtx *ctx, ColumnSpec **cols_out);
 
-/* Fecha alças. */
+/* Lê cabeçalho e descritores de campo de um header DBF em memória (sem shapelib,
+   mesmas regras de tipo). Preenche nfields/nrecords/header_len/record_len. */
+int dbf_parse_header(const unsigned char *h, size_t len, DbfCtx *ctx, ColumnSpec **cols_out);
+
+/* Só o cabeçalho de um .dbf ou .dbc (o header do .dbc não é comprimido), sem
+   mapear nem descompactar os registros: schema e nº de registros. `ctx` não
+   tem registros e não precisa de dbf_close(). Retorna 0 ok, < 0 erro. */
+int dbf_read_header(const char *path, DbfCtx *ctx, ColumnSpec **cols_out);
+
+/* Fecha alças, a stream (se houver) e desfaz o mapeamento. */
 void dbf_close(DbfCtx *ctx);
 
-/* Retorna 1 se registro está deletado ('*' no 1º byte do registro), 0 caso contrário, -1 erro IO. */
-int dbf_is_deleted(const DbfCtx *ctx, int row);
-
-/* Le leitura de valores por coluna/linha:
-   Retorna 1 se NULL, 0 se possui valor, -1 erro.
-   Saída:
-     - para COL_UTF8: *out_str alocado (precisa free), em UTF-8
-     - para COL_INT64: *out_i64
-     - para COL_FLOAT64: *out_f64
-     - para COL_BOOL: *out_bool (0/1)
-     - para COL_DATE32: *out_i32 (dias desde 1970-01-01)
-*/
-int dbf_read_value(const DbfCtx *ctx, const ColumnSpec *col, int col_idx, int row,
-                   const char *from_cp, int strict,
-                   char **out_str, long long *out_i64, double *out_f64, int *out_bool, int *out_i32);
+/* Prepara em *view os registros [row, row + n) para dbf_record(),
+   dbf_scan_deleted() e dbf_decode_column(). Arquivo mapeado: *view = *ctx, sem
+   cópia. Stream: copia os registros para um buffer (*owned; free() depois de
+   decodificar) e os lotes precisam vir em ordem (pular para frente descarta os
+   registros intermediários). A visão não deve ser fechada.
+   Retorna 0 ok, -1 erro (inclusive stream terminada antes da hora). */
+int dbf_fetch(DbfCtx *ctx, int row, int n, DbfCtx *view, unsigned char **owned);
+
+/* Visão dos primeiros `n` registros para amostragem (ex.: cardinalidade), sem
+   consumi-los: numa stream eles ficam guardados e dbf_fetch() os entrega
+   depois. Chamar antes do primeiro dbf_fetch(). Retorna 0 ok, -1 erro. */
+int dbf_sample(DbfCtx *ctx, int n, DbfCtx *view);
+
+/* Nº de valores distintos (bytes do campo, recortados; nulos não contam) da
+   coluna nos registros [row, row + n), parando em `limit`. *nonnull recebe o
+   nº de valores não nulos. Retorna -1 em erro. */
+int dbf_count_distinct(const DbfCtx *ctx, const ColumnSpec *col, int row, int n,
+                       int limit, int *nonnull);
+
+/* Soma dos comprimentos (bytes do campo, recortados; nulos não contam) da
+   coluna nos registros [row, row + n); *nonnull recebe o nº de não nulos.
+   Retorna -1 em erro. */
+long long dbf_text_bytes(const DbfCtx *ctx, const ColumnSpec *col, int row, int n, int *nonnull);
+
+/* Menor e maior valor (parser inteiro) da coluna inteira nos registros
+   [row, row + n). *nonnull recebe o nº de valores válidos (0: min/max sem
+   sentido). Retorna -1 em erro. */
+int dbf_int_range(const DbfCtx *ctx, const ColumnSpec *col, int row, int n,
+                  int64_t *min, int64_t *max, int *nonnull);
+
+/* Ponteiro para os bytes do registro `row` dentro do mapa (sem cópia).
+   Válido até dbf_close(). Não valida `row`. */
+static inline const unsigned char* dbf_record(const DbfCtx *ctx, int row) {
+    return ctx->map + ctx->header_len + (size_t)(row - ctx->base_row) * (size_t)ctx->record_len;
+}
+
+/* Bytes do campo `col` no registro `rec` sem os espaços das pontas (sem cópia),
+   e a regra de NULL do tipo nativo. Para filtros sobre os bytes crus (--where). */
+const char* dbf_field(const unsigned char *rec, const ColumnSpec *col, size_t *len);
+int dbf_field_is_null(const ColumnSpec *col, const char *p, size_t len);
+
+/* Número de um campo N/F (mesmo parser da decodificação). 0 ok, -1 não numérico. */
+int dbf_parse_f64(const char *p, size_t len, double *out);
+
+/* Dica de readahead para os registros [row, row + n) (varredura sequencial). */
+void dbf_prefetch(const DbfCtx *ctx, int row, int n);
+
+/* Varre de uma vez as flags de deletado dos registros [row, row + n).
+   Retorna o nº de deletados (-1 erro). Quando > 0, `sel` (capacidade n) recebe
+   os índices relativos (0..n-1) dos registros ativos, em ordem; quando 0 o lote
+   está todo ativo e `sel` não é tocado (o consumidor pula o filtro). */
+int dbf_scan_deleted(const DbfCtx *ctx, int row, int n, int *sel);
+
+/* Buffers de uma coluna decodificada, já no layout Arrow (alocados com malloc;
+   o arrow_writer os envolve sem cópia e passa a ser o dono):
+     - validity: bitmap LSB-first (1 = válido); NULL quando nnulls == 0
+     - values:   int8/16/32/64 / double / int32 (date32) por linha; bitmap para COL_BOOL;
+                 offsets int32 (nrows + 1) para COL_UTF8; 16 bytes por linha
+                 (complemento de 2, little-endian, escala col->decimals) para
+                 COL_DECIMAL128; índices int32 no dicionário para COL_UTF8 com dict
+     - data:     bytes UTF-8 concatenados (COL_UTF8; com dict, só os ndict
+                 valores distintos, delimitados por dict_offsets[ndict + 1]) */
+typedef struct {
+    int            nrows;
+    long long      nnulls;
+    unsigned char *validity;
+    void          *values;
+    size_t         values_len;
+    char          *data;
+    size_t         data_len;
+    size_t         data_cap;
+    int32_t       *dict_offsets;
+    int            ndict;
+    int            dict_cap;
+} ColBuf;
+
+/* Decodifica a coluna `col` para as linhas selecionadas do lote que começa em
+   `row`: linha k = row + sel[k] (ou row + k se sel == NULL), k < nsel.
+   Coluna com offset < 0 não lê o registro: repete col->value ou fica nula.
+   Retorna 0 ok; -1 erro de conversão (strict: byte inválido, decimal acima da
+   precisão, inteiro acima do tipo da largura) em *err_row; -2 sem memória /
+   lote grande demais; -3 inteiro fora da faixa da amostra (--infer sample) em *err_row. Em erro `out` fica vazio. */
+int dbf_decode_column(const DbfCtx *ctx, const ColumnSpec *col,
+                      int row, const int *sel, int nsel,
+                      EncCtx *enc, int strict,
+                      ColBuf *out, int *err_row);
+
+/* Libera buffers que não foram entregues ao Arrow. */
+void colbuf_free(ColBuf *b);
 
 #endif
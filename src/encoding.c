@@ -2,8 +2,14 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
+#include <strings.h>
+#include <stdint.h>
 #include <iconv.h>
 
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
 /* --- LDID --- */
 int read_ldid_byte(const char *dbf_path, unsigned char *out_ldid) {
     FILE *f = fopen(dbf_path, "rb");
@@ -29,53 +35,359 @@ const char* ldid_to_codepage(unsigned char id) {
     }
 }
 
-/* --- iconv --- */
-int to_utf8(const char *from_cp,
-            const char *in, size_t inlen,
-            char **out_utf8, size_t *outlen,
-            int strict)
-{
+const char* enc_resolve_codepage(const char *dbf_path, const char *label) {
+    if (label && strcasecmp(label, "auto") != 0) return label;
+    unsigned char ldid = 0;
+    if (read_ldid_byte(dbf_path, &ldid) == 0) {
+        const char *cp = ldid_to_codepage(ldid);
+        if (cp) return cp;
+    }
+    return "CP1252";
+}
+
+/* --- kernels de bytes --- */
+size_t enc_rtrim_len(const char *s, size_t len) {
+    const unsigned char *p = (const unsigned char*)s;
+#if defined(__AVX2__)
+    /* b > ' ' sem sinal  <=>  (b ^ 0x80) > (' ' ^ 0x80) com sinal */
+    const __m256i flip32 = _mm256_set1_epi8((char)0x80);
+    const __m256i sp32   = _mm256_set1_epi8((char)(' ' ^ 0x80));
+    while (len >= 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(p + len - 32));
+        unsigned m = (unsigned)_mm256_movemask_epi8(
+            _mm256_cmpgt_epi8(_mm256_xor_si256(v, flip32), sp32));
+        if (m) return len - 32 + (size_t)(31 - __builtin_clz(m)) + 1;
+        len -= 32;
+    }
+#endif
+#if defined(__SSE2__)
+    const __m128i flip = _mm_set1_epi8((char)0x80);
+    const __m128i sp   = _mm_set1_epi8((char)(' ' ^ 0x80));
+    while (len >= 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(p + len - 16));
+        unsigned m = (unsigned)_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_xor_si128(v, flip), sp));
+        if (m) return len - 16 + (size_t)(31 - __builtin_clz(m)) + 1;
+        len -= 16;
+    }
+#endif
+    while (len > 0 && p[len - 1] <= ' ') len--;
+    return len;
+}
+
+int enc_is_ascii(const char *s, size_t len) {
+    const unsigned char *p = (const unsigned char*)s;
+    size_t i = 0;
+#if defined(__AVX2__)
+    __m256i acc32 = _mm256_setzero_si256();
+    for (; i + 32 <= len; i += 32)
+        acc32 = _mm256_or_si256(acc32, _mm256_loadu_si256((const __m256i*)(p + i)));
+    if (_mm256_movemask_epi8(acc32)) return 0;
+#endif
+#if defined(__SSE2__)
+    __m128i acc = _mm_setzero_si128();
+    for (; i + 16 <= len; i += 16)
+        acc = _mm_or_si128(acc, _mm_loadu_si128((const __m128i*)(p + i)));
+    if (_mm_movemask_epi8(acc)) return 0;
+#endif
+    /* SWAR: 8 bytes por vez, depois o resto */
+    uint64_t acc8 = 0;
+    for (; i + 8 <= len; i += 8) {
+        uint64_t w;
+        memcpy(&w, p + i, 8);
+        acc8 |= w;
+    }
+    for (; i < len; i++) acc8 |= p[i];
+    return (acc8 & 0x8080808080808080ULL) == 0;
+}
+
+/* --- tabelas de codepages de 1 byte ---
+   Code points Unicode dos bytes 0x80..0xFF (0 = byte indefinido na codepage);
+   0x00..0x7F é ASCII em todas. Conferidas contra o iconv da glibc. */
+static const unsigned short CP1252_hi[128] = {
+    0x20AC, 0x0000, 0x201A, 0x0192, 0x201E, 0x2026, 0x2020, 0x2021,
+    0x02C6, 0x2030, 0x0160, 0x2039, 0x0152, 0x0000, 0x017D, 0x0000,
+    0x0000, 0x2018, 0x2019, 0x201C, 0x201D, 0x2022, 0x2013, 0x2014,
+    0x02DC, 0x2122, 0x0161, 0x203A, 0x0153, 0x0000, 0x017E, 0x0178,
+    0x00A0, 0x00A1, 0x00A2, 0x00A3, 0x00A4, 0x00A5, 0x00A6, 0x00A7,
+    0x00A8, 0x00A9, 0x00AA, 0x00AB, 0x00AC, 0x00AD, 0x00AE, 0x00AF,
+    0x00B0, 0x00B1, 0x00B2, 0x00B3, 0x00B4, 0x00B5, 0x00B6, 0x00B7,
+    0x00B8, 0x00B9, 0x00BA, 0x00BB, 0x00BC, 0x00BD, 0x00BE, 0x00BF,
+    0x00C0, 0x00C1, 0x00C2, 0x00C3, 0x00C4, 0x00C5, 0x00C6, 0x00C7,
+    0x00C8, 0x00C9, 0x00CA, 0x00CB, 0x00CC, 0x00CD, 0x00CE, 0x00CF,
+    0x00D0, 0x00D1, 0x00D2, 0x00D3, 0x00D4, 0x00D5, 0x00D6, 0x00D7,
+    0x00D8, 0x00D9, 0x00DA, 0x00DB, 0x00DC, 0x00DD, 0x00DE, 0x00DF,
+    0x00E0, 0x00E1, 0x00E2, 0x00E3, 0x00E4, 0x00E5, 0x00E6, 0x00E7,
+    0x00E8, 0x00E9, 0x00EA, 0x00EB, 0x00EC, 0x00ED, 0x00EE, 0x00EF,
+    0x00F0, 0x00F1, 0x00F2, 0x00F3, 0x00F4, 0x00F5, 0x00F6, 0x00F7,
+    0x00F8, 0x00F9, 0x00FA, 0x00FB, 0x00FC, 0x00FD, 0x00FE, 0x00FF,
+};
+
+static const unsigned short CP850_hi[128] = {
+    0x00C7, 0x00FC, 0x00E9, 0x00E2, 0x00E4, 0x00E0, 0x00E5, 0x00E7,
+    0x00EA, 0x00EB, 0x00E8, 0x00EF, 0x00EE, 0x00EC, 0x00C4, 0x00C5,
+    0x00C9, 0x00E6, 0x00C6, 0x00F4, 0x00F6, 0x00F2, 0x00FB, 0x00F9,
+    0x00FF, 0x00D6, 0x00DC, 0x00F8, 0x00A3, 0x00D8, 0x00D7, 0x0192,
+    0x00E1, 0x00ED, 0x00F3, 0x00FA, 0x00F1, 0x00D1, 0x00AA, 0x00BA,
+    0x00BF, 0x00AE, 0x00AC, 0x00BD, 0x00BC, 0x00A1, 0x00AB, 0x00BB,
+    0x2591, 0x2592, 0x2593, 0x2502, 0x2524, 0x00C1, 0x00C2, 0x00C0,
+    0x00A9, 0x2563, 0x2551, 0x2557, 0x255D, 0x00A2, 0x00A5, 0x2510,
+    0x2514, 0x2534, 0x252C, 0x251C, 0x2500, 0x253C, 0x00E3, 0x00C3,
+    0x255A, 0x2554, 0x2569, 0x2566, 0x2560, 0x2550, 0x256C, 0x00A4,
+    0x00F0, 0x00D0, 0x00CA, 0x00CB, 0x00C8, 0x0131, 0x00CD, 0x00CE,
+    0x00CF, 0x2518, 0x250C, 0x2588, 0x2584, 0x00A6, 0x00CC, 0x2580,
+    0x00D3, 0x00DF, 0x00D4, 0x00D2, 0x00F5, 0x00D5, 0x00B5, 0x00FE,
+    0x00DE, 0x00DA, 0x00DB, 0x00D9, 0x00FD, 0x00DD, 0x00AF, 0x00B4,
+    0x00AD, 0x00B1, 0x2017, 0x00BE, 0x00B6, 0x00A7, 0x00F7, 0x00B8,
+    0x00B0, 0x00A8, 0x00B7, 0x00B9, 0x00B3, 0x00B2, 0x25A0, 0x00A0,
+};
+
+static const unsigned short CP437_hi[128] = {
+    0x00C7, 0x00FC, 0x00E9, 0x00E2, 0x00E4, 0x00E0, 0x00E5, 0x00E7,
+    0x00EA, 0x00EB, 0x00E8, 0x00EF, 0x00EE, 0x00EC, 0x00C4, 0x00C5,
+    0x00C9, 0x00E6, 0x00C6, 0x00F4, 0x00F6, 0x00F2, 0x00FB, 0x00F9,
+    0x00FF, 0x00D6, 0x00DC, 0x00A2, 0x00A3, 0x00A5, 0x20A7, 0x0192,
+    0x00E1, 0x00ED, 0x00F3, 0x00FA, 0x00F1, 0x00D1, 0x00AA, 0x00BA,
+    0x00BF, 0x2310, 0x00AC, 0x00BD, 0x00BC, 0x00A1, 0x00AB, 0x00BB,
+    0x2591, 0x2592, 0x2593, 0x2502, 0x2524, 0x2561, 0x2562, 0x2556,
+    0x2555, 0x2563, 0x2551, 0x2557, 0x255D, 0x255C, 0x255B, 0x2510,
+    0x2514, 0x2534, 0x252C, 0x251C, 0x2500, 0x253C, 0x255E, 0x255F,
+    0x255A, 0x2554, 0x2569, 0x2566, 0x2560, 0x2550, 0x256C, 0x2567,
+    0x2568, 0x2564, 0x2565, 0x2559, 0x2558, 0x2552, 0x2553, 0x256B,
+    0x256A, 0x2518, 0x250C, 0x2588, 0x2584, 0x258C, 0x2590, 0x2580,
+    0x03B1, 0x00DF, 0x0393, 0x03C0, 0x03A3, 0x03C3, 0x00B5, 0x03C4,
+    0x03A6, 0x0398, 0x03A9, 0x03B4, 0x221E, 0x03C6, 0x03B5, 0x2229,
+    0x2261, 0x00B1, 0x2265, 0x2264, 0x2320, 0x2321, 0x00F7, 0x2248,
+    0x00B0, 0x2219, 0x00B7, 0x221A, 0x207F, 0x00B2, 0x25A0, 0x00A0,
+};
+
+static const unsigned short CP1250_hi[128] = {
+    0x20AC, 0x0000, 0x201A, 0x0000, 0x201E, 0x2026, 0x2020, 0x2021,
+    0x0000, 0x2030, 0x0160, 0x2039, 0x015A, 0x0164, 0x017D, 0x0179,
+    0x0000, 0x2018, 0x2019, 0x201C, 0x201D, 0x2022, 0x2013, 0x2014,
+    0x0000, 0x2122, 0x0161, 0x203A, 0x015B, 0x0165, 0x017E, 0x017A,
+    0x00A0, 0x02C7, 0x02D8, 0x0141, 0x00A4, 0x0104, 0x00A6, 0x00A7,
+    0x00A8, 0x00A9, 0x015E, 0x00AB, 0x00AC, 0x00AD, 0x00AE, 0x017B,
+    0x00B0, 0x00B1, 0x02DB, 0x0142, 0x00B4, 0x00B5, 0x00B6, 0x00B7,
+    0x00B8, 0x0105, 0x015F, 0x00BB, 0x013D, 0x02DD, 0x013E, 0x017C,
+    0x0154, 0x00C1, 0x00C2, 0x0102, 0x00C4, 0x0139, 0x0106, 0x00C7,
+    0x010C, 0x00C9, 0x0118, 0x00CB, 0x011A, 0x00CD, 0x00CE, 0x010E,
+    0x0110, 0x0143, 0x0147, 0x00D3, 0x00D4, 0x0150, 0x00D6, 0x00D7,
+    0x0158, 0x016E, 0x00DA, 0x0170, 0x00DC, 0x00DD, 0x0162, 0x00DF,
+    0x0155, 0x00E1, 0x00E2, 0x0103, 0x00E4, 0x013A, 0x0107, 0x00E7,
+    0x010D, 0x00E9, 0x0119, 0x00EB, 0x011B, 0x00ED, 0x00EE, 0x010F,
+    0x0111, 0x0144, 0x0148, 0x00F3, 0x00F4, 0x0151, 0x00F6, 0x00F7,
+    0x0159, 0x016F, 0x00FA, 0x0171, 0x00FC, 0x00FD, 0x0163, 0x02D9,
+};
+
+static const unsigned short CP1251_hi[128] = {
+    0x0402, 0x0403, 0x201A, 0x0453, 0x201E, 0x2026, 0x2020, 0x2021,
+    0x20AC, 0x2030, 0x0409, 0x2039, 0x040A, 0x040C, 0x040B, 0x040F,
+    0x0452, 0x2018, 0x2019, 0x201C, 0x201D, 0x2022, 0x2013, 0x2014,
+    0x0000, 0x2122, 0x0459, 0x203A, 0x045A, 0x045C, 0x045B, 0x045F,
+    0x00A0, 0x040E, 0x045E, 0x0408, 0x00A4, 0x0490, 0x00A6, 0x00A7,
+    0x0401, 0x00A9, 0x0404, 0x00AB, 0x00AC, 0x00AD, 0x00AE, 0x0407,
+    0x00B0, 0x00B1, 0x0406, 0x0456, 0x0491, 0x00B5, 0x00B6, 0x00B7,
+    0x0451, 0x2116, 0x0454, 0x00BB, 0x0458, 0x0405, 0x0455, 0x0457,
+    0x0410, 0x0411, 0x0412, 0x0413, 0x0414, 0x0415, 0x0416, 0x0417,
+    0x0418, 0x0419, 0x041A, 0x041B, 0x041C, 0x041D, 0x041E, 0x041F,
+    0x0420, 0x0421, 0x0422, 0x0423, 0x0424, 0x0425, 0x0426, 0x0427,
+    0x0428, 0x0429, 0x042A, 0x042B, 0x042C, 0x042D, 0x042E, 0x042F,
+    0x0430, 0x0431, 0x0432, 0x0433, 0x0434, 0x0435, 0x0436, 0x0437,
+    0x0438, 0x0439, 0x043A, 0x043B, 0x043C, 0x043D, 0x043E, 0x043F,
+    0x0440, 0x0441, 0x0442, 0x0443, 0x0444, 0x0445, 0x0446, 0x0447,
+    0x0448, 0x0449, 0x044A, 0x044B, 0x044C, 0x044D, 0x044E, 0x044F,
+};
+
+typedef struct {
+    const char *label;
+    const char *alias;
+    const unsigned short *hi;
+} CpTable;
+
+static const CpTable cp_tables[] = {
+    { "CP1252", "WINDOWS-1252", CP1252_hi },
+    { "CP850",  "IBM850",       CP850_hi  },
+    { "CP437",  "IBM437",       CP437_hi  },
+    { "CP1250", "WINDOWS-1250", CP1250_hi },
+    { "CP1251", "WINDOWS-1251", CP1251_hi },
+};
+
+/* Expande os code points em sequências UTF-8 prontas para cópia */
+static void build_table(unsigned char table[256][4], const unsigned short *hi) {
+    for (int b = 0; b < 256; b++) {
+        unsigned cp = b < 0x80 ? (unsigned)b : hi[b - 0x80];
+        unsigned char *e = table[b];
+        e[0] = e[1] = e[2] = 0;
+        if (b >= 0x80 && cp == 0) {         /* indefinido: '?' + marca inválido */
+            e[0] = '?'; e[3] = 0x80 | 1;
+        } else if (cp < 0x80) {
+            e[0] = (unsigned char)cp; e[3] = 1;
+        } else if (cp < 0x800) {
+            e[0] = (unsigned char)(0xC0 | (cp >> 6));
+            e[1] = (unsigned char)(0x80 | (cp & 0x3F));
+            e[3] = 2;
+        } else {
+            e[0] = (unsigned char)(0xE0 | (cp >> 12));
+            e[1] = (unsigned char)(0x80 | ((cp >> 6) & 0x3F));
+            e[2] = (unsigned char)(0x80 | (cp & 0x3F));
+            e[3] = 3;
+        }
+    }
+}
+
+int enc_open(EncCtx *enc, const char *from_cp) {
+    memset(enc, 0, sizeof(*enc));
     const char *src_cp = from_cp ? from_cp : "CP1252";
-    iconv_t cd = iconv_open("UTF-8//TRANSLIT", src_cp);
-    if (cd == (iconv_t)-1) return -1;
+    strncpy(enc->cp, src_cp, sizeof(enc->cp) - 1);
+
+    for (size_t i = 0; i < sizeof(cp_tables) / sizeof(cp_tables[0]); i++) {
+        if (strcasecmp(src_cp, cp_tables[i].label) == 0 ||
+            strcasecmp(src_cp, cp_tables[i].alias) == 0) {
+            build_table(enc->table, cp_tables[i].hi);
+            enc->has_table = 1;
+            break;
+        }
+    }
+
+    if (enc->has_table) {
+        enc->ascii_compat = 1;
+    } else {
+        iconv_t cd = iconv_open("UTF-8//TRANSLIT", src_cp);
+        if (cd == (iconv_t)-1) {
+            enc->ascii_compat = 1; /* bytes passam adiante de qualquer forma */
+        } else {
+            enc->cd = (void*)cd;
+            /* atalho ASCII só se a codepage mapeia 0x01..0x7F para ela mesma */
+            char in[127], out[127 * 4];
+            for (int b = 1; b < 128; b++) in[b - 1] = (char)b;
+            char *pin = in, *pout = out;
+            size_t inleft = sizeof(in), outleft = sizeof(out);
+            enc->ascii_compat =
+                iconv(cd, &pin, &inleft, &pout, &outleft) != (size_t)-1 &&
+                inleft == 0 && (size_t)(pout - out) == sizeof(in) &&
+                memcmp(in, out, sizeof(in)) == 0;
+            iconv(cd, NULL, NULL, NULL, NULL);
+        }
+    }
+
+    return 0;
+}
+
+void enc_close(EncCtx *enc) {
+    if (!enc) return;
+    if (enc->cd) iconv_close((iconv_t)enc->cd);
+    memset(enc, 0, sizeof(*enc));
+}
+
+/* Kernel de tabela: cópia incondicional de 4 bytes por entrada, avança pelo
+   tamanho real. Exige 3 bytes de folga após a saída. Retorna o OR dos
+   marcadores (bit 0x80 = houve byte inválido). */
+static unsigned table_kernel(const unsigned char table[256][4],
+                             const unsigned char *in, size_t n,
+                             unsigned char **pout) {
+    unsigned char *o = *pout;
+    unsigned flags = 0;
+    for (size_t i = 0; i < n; i++) {
+        const unsigned char *e = table[in[i]];
+        memcpy(o, e, 4);
+        o += e[3] & 0x03;
+        flags |= e[3];
+    }
+    *pout = o;
+    return flags;
+}
+
+int enc_from_utf8(const EncCtx *enc, const char *utf8, size_t len, char *dst, size_t *outlen) {
+    if (enc_is_ascii(utf8, len) && enc->ascii_compat) {
+        memcpy(dst, utf8, len);
+        *outlen = len;
+        return 0;
+    }
+    if (!enc->has_table) return -1;
+
+    size_t o = 0;
+    for (size_t i = 0; i < len; ) {
+        /* tamanho do caractere UTF-8 pelo 1º byte */
+        unsigned char c = (unsigned char)utf8[i];
+        size_t n = c < 0x80 ? 1 : c < 0xE0 ? 2 : c < 0xF0 ? 3 : 4;
+        if (i + n > len) return -1;
+        int b = 0;
+        for (; b < 256; b++) {
+            const unsigned char *e = enc->table[b];
+            if ((e[3] & 0x80) == 0 && (size_t)(e[3] & 0x03) == n && memcmp(e, utf8 + i, n) == 0) break;
+        }
+        if (b == 256) return -1;
+        dst[o++] = (char)b;
+        i += n;
+    }
+    *outlen = o;
+    return 0;
+}
+
+size_t enc_utf8_bound(const EncCtx *enc, size_t inlen) {
+    /* iconv: até 4 bytes por caractere; tabela: até 3 + folga da cópia de 4 bytes */
+    return enc->cd ? inlen * 4 + 8 : inlen * 3 + 4;
+}
+
+int enc_convert(EncCtx *enc,
+                const char *in, size_t inlen,
+                char *dst, size_t *outlen,
+                int strict)
+{
+    if (enc->ascii_compat && enc_is_ascii(in, inlen)) {
+        /* caso comum: célula só ASCII é UTF-8 válido como está */
+        memcpy(dst, in, inlen);
+        *outlen = inlen;
+        return 0;
+    }
 
-    size_t cap = inlen * 4 + 8;
-    char *out = (char*)malloc(cap);
-    if (!out) { iconv_close(cd); return -1; }
+    if (enc->has_table) {
+        unsigned char *o = (unsigned char*)dst;
+        unsigned flags = table_kernel((const unsigned char (*)[4])enc->table,
+                                      (const unsigned char*)in, inlen, &o);
+        if (flags & 0x80) {
+            if (strict) return -2;
+            enc->replaced++;
+        }
+        enc->transcoded++;
+        *outlen = (size_t)(o - (unsigned char*)dst);
+        return 0;
+    }
+
+    if (!enc->cd) {
+        /* sem conversor: bytes como estão (comportamento antigo) */
+        memcpy(dst, in, inlen);
+        *outlen = inlen;
+        return 0;
+    }
+
+    /* --- iconv (codepages multibyte ou sem tabela) --- */
+    iconv_t cd = (iconv_t)enc->cd;
+    iconv(cd, NULL, NULL, NULL, NULL); /* zera estado após erro anterior */
 
     char *pin = (char*)in;
-    char *pout = out;
-    size_t inleft = inlen, outleft = cap;
+    char *pout = dst;
+    size_t inleft = inlen, outleft = enc_utf8_bound(enc, inlen);
+    int replaced = 0;
 
     while (inleft > 0) {
         size_t r = iconv(cd, &pin, &inleft, &pout, &outleft);
         if (r == (size_t)-1) {
             if (!strict) {
                 /* substitui por '?' e avança 1 byte */
-                if (outleft == 0) { free(out); iconv_close(cd); return -1; }
+                if (outleft == 0) return -1;
                 *pout++ = '?'; outleft--;
                 pin++; inleft--;
+                replaced = 1;
+                iconv(cd, NULL, NULL, NULL, NULL);
                 continue;
             } else {
-                free(out); iconv_close(cd); return -2;
+                return -2;
             }
         }
     }
-    *outlen = (size_t)(pout - out);
-    /* garanta NUL no fim (Arrow-GLib recebe const gchar*) */
-    if (outleft == 0) {
-        /* realoca se necessário para caber o NUL */
-        size_t used = *outlen;
-        size_t newcap = used + 1;
-        char *tmp = (char*)realloc(out, newcap);
-        if (!tmp) { free(out); iconv_close(cd); return -1; }
-        out = tmp;
-        pout = out + used;
-        outleft = 1;
-    }
-    *pout = '\0';
-
-    *out_utf8 = out;
-    iconv_close(cd);
+    enc->transcoded++;
+    enc->replaced += replaced;
+    *outlen = (size_t)(pout - dst);
     return 0;
 }
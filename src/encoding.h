@@ -10,13 +10,59 @@ int read_ldid_byte(const char *dbf_path, unsigned char *out_ldid);
 /* Mapeia LDID comuns para label de codepage (iconv). Retorna NULL se desconhecido. */
 const char* ldid_to_codepage(unsigned char ldid);
 
-/* Converte bytes (em `from_cp`) para UTF-8.
+/* Codepage de origem de um arquivo: `label` se não for "auto"/NULL; senão pelo
+   LDID do header (.dbf ou .dbc) e, se desconhecido, CP1252. */
+const char* enc_resolve_codepage(const char *dbf_path, const char *label);
+
+/* Conversor para UTF-8 resolvido uma vez por arquivo (não compartilhar entre threads).
+   Codepages de 1 byte conhecidas (CP1252/850/437/1250/1251) usam tabela byte→UTF-8;
+   as demais usam iconv com descritor aberto uma única vez. */
+typedef struct {
+    char   cp[32];                  /* label da codepage de origem */
+    int    has_table;               /* 1 = usa table[] */
+    int    ascii_compat;            /* 1 = bytes < 0x80 são ASCII (atalho sem conversão) */
+    unsigned char table[256][4];    /* bytes UTF-8 em [0..2]; [3] = tamanho, bit 0x80 = inválido */
+    void  *cd;                      /* iconv_t em cache (fallback) ou NULL */
+    long long transcoded;           /* textos não-ASCII convertidos (tabela ou iconv) */
+    long long replaced;             /* desses, com byte inválido trocado por '?' */
+} EncCtx;
+
+/* Comprimento de s[0..len) sem os bytes finais <= ' ' (espaço/controle).
+   SSE2/AVX2 em blocos de 16/32 bytes, de trás para frente. */
+size_t enc_rtrim_len(const char *s, size_t len);
+
+/* 1 se todos os bytes de s[0..len) são < 0x80. SSE2/AVX2 em blocos de 16/32. */
+int enc_is_ascii(const char *s, size_t len);
+
+/* Prepara o conversor para `from_cp` (NULL = CP1252). Retorna 0 ok.
+   Codepage sem tabela nem iconv (enc_is_passthrough): bytes passam sem conversão. */
+int enc_open(EncCtx *enc, const char *from_cp);
+
+/* 1 se a codepage não tem tabela nem iconv (strings copiadas como estão). */
+#define enc_is_passthrough(enc) (!(enc)->has_table && !(enc)->cd)
+
+/* Libera o descritor iconv. */
+void enc_close(EncCtx *enc);
+
+/* Caminho inverso, para comparar valores com bytes crus do arquivo (--where):
+   converte `utf8` para a codepage de `enc` em `dst` (capacidade >= len).
+   Codepages com tabela são invertidas pela tabela; as demais só aceitam
+   texto ASCII (quando a codepage é compatível). Retorna 0 ok, -1 caractere
+   sem representação na codepage. */
+int enc_from_utf8(const EncCtx *enc, const char *utf8, size_t len, char *dst, size_t *outlen);
+
+/* Máximo de bytes que enc_convert() pode escrever para `inlen` bytes de entrada. */
+size_t enc_utf8_bound(const EncCtx *enc, size_t inlen);
+
+/* Converte bytes (na codepage de `enc`) para UTF-8, direto em `dst` (capacidade
+   >= enc_utf8_bound(), sem NUL no fim): o decodificador colunar grava no buffer
+   do lote. Células só ASCII são copiadas sem passar pela tabela/iconv; as
+   demais contam em enc->transcoded (e em enc->replaced se algum byte virou '?').
    strict=1 → erro ao 1º byte inválido; strict=0 → substitui inválidos por '?'.
-   Retorna 0 em sucesso; -1 falha ao abrir iconv; -2 erro de conversão (strict).
-   *out_utf8 precisa de free(). */
-int to_utf8(const char *from_cp,
-            const char *in, size_t inlen,
-            char **out_utf8, size_t *outlen,
-            int strict);
+   Retorna 0 em sucesso; -1 sem memória; -2 erro de conversão (strict). */
+int enc_convert(EncCtx *enc,
+                const char *in, size_t inlen,
+                char *dst, size_t *outlen,
+                int strict);
 
 #endif
@@ -0,0 +1,132 @@
+#include "incremental.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <errno.h>
+#include <glib.h>
+
+#define INC_GROUP "dbf2parquet-incremental"
+
+static int inc_fail(char *msg, size_t msglen, const char *fmt, ...) G_GNUC_PRINTF(3, 4);
+static int inc_fail(char *msg, size_t msglen, const char *fmt, ...) {
+    va_list ap;
+    va_start(ap, fmt);
+    vsnprintf(msg, msglen, fmt, ap);
+    va_end(ap);
+    return -1;
+}
+
+int inc_load(const char *path, IncState *st, char *msg, size_t msglen) {
+    memset(st, 0, sizeof(*st));
+    if (!g_file_test(path, G_FILE_TEST_EXISTS)) return 0;
+
+    GKeyFile *kf = g_key_file_new();
+    GError *error = NULL;
+    int rc = 0;
+    if (!g_key_file_load_from_file(kf, path, G_KEY_FILE_NONE, &error)) {
+        rc = inc_fail(msg, msglen, "%s: estado ilegível: %s", path, error->message);
+        g_error_free(error);
+        g_key_file_free(kf);
+        return rc;
+    }
+
+    char *hash = g_key_file_get_string(kf, INC_GROUP, "prefix_hash", NULL);
+    char *date = g_key_file_get_string(kf, INC_GROUP, "header_date", NULL);
+    st->records    = (long long)g_key_file_get_int64(kf, INC_GROUP, "records", NULL);
+    st->parts      = g_key_file_get_integer(kf, INC_GROUP, "parts", NULL);
+    st->header_len = (long)g_key_file_get_int64(kf, INC_GROUP, "header_len", NULL);
+    st->record_len = (long)g_key_file_get_int64(kf, INC_GROUP, "record_len", NULL);
+    st->schema     = g_key_file_get_string(kf, INC_GROUP, "schema", NULL);
+    if (hash) st->prefix_hash = g_ascii_strtoull(hash, NULL, 16);
+    if (date) g_strlcpy(st->header_date, date, sizeof(st->header_date));
+
+    if (!hash || !st->schema || st->parts <= 0 || st->records < 0 ||
+        st->header_len <= 0 || st->record_len <= 0) {
+        rc = inc_fail(msg, msglen, "%s: estado incompleto (apague-o para reconverter do início).", path);
+        inc_clear(st);
+    }
+    g_free(hash);
+    g_free(date);
+    g_key_file_free(kf);
+    return rc;
+}
+
+int inc_save(const char *path, const IncState *st, const char *input, char *msg, size_t msglen) {
+    GKeyFile *kf = g_key_file_new();
+    char hash[17];
+    snprintf(hash, sizeof(hash), "%016llx", (unsigned long long)st->prefix_hash);
+    g_key_file_set_string(kf, INC_GROUP, "input", input);
+    g_key_file_set_int64(kf, INC_GROUP, "records", st->records);
+    g_key_file_set_integer(kf, INC_GROUP, "parts", st->parts);
+    g_key_file_set_int64(kf, INC_GROUP, "header_len", st->header_len);
+    g_key_file_set_int64(kf, INC_GROUP, "record_len", st->record_len);
+    g_key_file_set_string(kf, INC_GROUP, "prefix_hash", hash);
+    g_key_file_set_string(kf, INC_GROUP, "header_date", st->header_date);
+    g_key_file_set_string(kf, INC_GROUP, "schema", st->schema ? st->schema : "");
+
+    /* g_key_file_save_to_file grava num temporário e renomeia: sem estado truncado */
+    GError *error = NULL;
+    int rc = 0;
+    if (!g_key_file_save_to_file(kf, path, &error)) {
+        rc = inc_fail(msg, msglen, "%s: erro gravando o estado: %s", path, error->message);
+        g_error_free(error);
+    }
+    g_key_file_free(kf);
+    return rc;
+}
+
+void inc_clear(IncState *st) {
+    g_free(st->schema);
+    memset(st, 0, sizeof(*st));
+}
+
+uint64_t inc_hash_records(const DbfCtx *ctx, int row, int n, uint64_t h) {
+    const uint64_t prime = 0x100000001b3ULL;
+    const size_t rl = (size_t)ctx->record_len;
+    const unsigned char *rec = dbf_record(ctx, row);
+    for (int r = 0; r < n; r++, rec += rl) {
+        size_t i = 0;
+        for (; i + 8 <= rl; i += 8) {
+            uint64_t w;
+            memcpy(&w, rec + i, 8);
+            h = (h ^ w) * prime;
+        }
+        for (; i < rl; i++) h = (h ^ rec[i]) * prime;
+    }
+    return h;
+}
+
+void inc_header_date(const DbfCtx *ctx, char out[11]) {
+    const unsigned char *h = ctx->map;
+    snprintf(out, 11, "%04d-%02d-%02d", 1900 + h[1], h[2] % 100, h[3] % 100);
+}
+
+char* inc_schema_string(const ColumnSpec *cols, int ncols) {
+    GString *s = g_string_new(NULL);
+    for (int i = 0; i < ncols; i++)
+        g_string_append_printf(s, "%s%s:%d:%d:%d:%d:%d", i ? "," : "", cols[i].name,
+                               (int)cols[i].kind, cols[i].width, cols[i].decimals,
+                               cols[i].offset, cols[i].dict);
+    return g_string_free(s, FALSE);
+}
+
+int inc_apply_schema(const char *schema, ColumnSpec *cols, int ncols) {
+    char **items = g_strsplit(schema, ",", -1);
+    int rc = (int)g_strv_length(items) == ncols ? 0 : -1;
+    for (int i = 0; rc == 0 && i < ncols; i++) {
+        char name[64];
+        int kind, width, decimals, offset, dict;
+        if (sscanf(items[i], "%63[^:]:%d:%d:%d:%d:%d", name, &kind, &width, &decimals, &offset, &dict) != 6 ||
+            strcmp(name, cols[i].name) != 0 || width != cols[i].width ||
+            decimals != cols[i].decimals || offset != cols[i].offset) {
+            rc = -1;
+            break;
+        }
+        cols[i].kind = (ColKind)kind;
+        cols[i].dict = dict;
+    }
+    g_strfreev(items);
+    return rc;
+}
@@ -0,0 +1,47 @@
+#ifndef INCREMENTAL_H
+#define INCREMENTAL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "dbf_reader.h"
+
+/* --incremental: estado de uma tabela DBF que só cresce (registros novos
+   acrescentados no fim). Cada execução converte só os registros novos numa
+   parte nova (<saída>-00001.parquet, -00002, ...) e grava o estado. */
+typedef struct {
+    long long records;      /* registros já convertidos (prefixo) */
+    int       parts;        /* partes já gravadas (0 = 1ª execução) */
+    long      header_len;
+    long      record_len;
+    uint64_t  prefix_hash;  /* inc_hash_records() de [0, records), flags de deletado incluídas */
+    char      header_date[11]; /* AAAA-MM-DD da última alteração, pelo cabeçalho */
+    char     *schema;       /* colunas das partes (inc_schema_string; g_free) */
+} IncState;
+
+/* Lê o estado de `path`. Arquivo inexistente = 1ª execução (*st zerado).
+   Retorna 0 ok, -1 arquivo ilegível (mensagem em `msg`). */
+int inc_load(const char *path, IncState *st, char *msg, size_t msglen);
+
+/* Grava o estado (substitui o arquivo de uma vez). Retorna 0 ok, -1 erro. */
+int inc_save(const char *path, const IncState *st, const char *input, char *msg, size_t msglen);
+
+void inc_clear(IncState *st);
+
+/* Hash (FNV-1a em palavras de 8 bytes) dos registros [row, row + n) de um
+   arquivo mapeado, continuando de `h` (INC_HASH_SEED no início). Registro a
+   registro: o hash de [0, a) continuado com [a, b) é o hash de [0, b). */
+#define INC_HASH_SEED 0xcbf29ce484222325ULL
+uint64_t inc_hash_records(const DbfCtx *ctx, int row, int n, uint64_t h);
+
+/* Data de última alteração do cabeçalho (bytes 1..3) como AAAA-MM-DD. */
+void inc_header_date(const DbfCtx *ctx, char out[11]);
+
+/* Colunas gravadas (nome, tipo e dicionário) como texto, para que todas as
+   partes tenham o mesmo schema (g_free). */
+char* inc_schema_string(const ColumnSpec *cols, int ncols);
+
+/* Reaplica os tipos/dicionário de `schema` a `cols` (em vez de amostrar de
+   novo). Retorna 0 ok, -1 colunas diferentes (outro layout ou outras opções). */
+int inc_apply_schema(const char *schema, ColumnSpec *cols, int ncols);
+
+#endif
@@ -3,71 +3,150 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stddef.h>
-#include <ctype.h>
+#include <stdarg.h>
+#include <limits.h>
 #include <getopt.h>
 #include <glib.h>
+#include <glib/gstdio.h>
 #include "dbf_reader.h"
 #include "encoding.h"
 #include "arrow_writer.h"
-#include <limits.h>
-
-/* Concatena base + ext garantindo capacidade; retorna 0 ok, -1 erro */
-static int join_with_ext(char *dst, size_t dstsz, const char *base, const char *ext) {
-    size_t nb = strlen(base);
-    size_t ne = strlen(ext);
-    if (nb + ne + 1 > dstsz) return -1;
-    memcpy(dst, base, nb);
-    memcpy(dst + nb, ext, ne);
-    dst[nb + ne] = '\0';
-    return 0;
-}
-
-/* Cópia simples de arquivo binário */
-static int copy_file(const char *src, const char *dst) {
-    FILE *in = fopen(src, "rb");
-    if (!in) { fprintf(stderr, "copy_file: fopen('%s'): %s\n", src, strerror(errno)); return -1; }
-    FILE *out = fopen(dst, "wb");
-    if (!out) { fprintf(stderr, "copy_file: fopen('%s'): %s\n", dst, strerror(errno)); fclose(in); return -1; }
-
-    char buf[1 << 16];
-    size_t n;
-    int rc = 0;
-    while ((n = fread(buf, 1, sizeof(buf), in)) > 0) {
-        if (fwrite(buf, 1, n, out) != n) { rc = -1; fprintf(stderr, "copy_file: erro ao escrever '%s'\n", dst); break; }
-    }
-    if (ferror(in)) { rc = -1; fprintf(stderr, "copy_file: erro ao ler '%s'\n", src); }
-    fclose(out);
-    fclose(in);
-    if (rc != 0) remove(dst);
-    return rc;
-}
-
+#include "dbc_reader.h"
+#include "convert.h"
+#include "batch.h"
+#include "merge.h"
+#include "incremental.h"
+#include "resume.h"
+#include "stats.h"
 
 typedef struct {
     const char *input;
     const char *output;
+    const char *input_dir;   /* modo lote: .dbf/.dbc de um diretório */
+    const char *input_glob;  /* modo lote: curinga no nome ("dir/RD*.dbc") */
+    const char *input_list;  /* modo lote: arquivo com um caminho por linha */
+    const char *output_dir;  /* modo lote: um .parquet por entrada */
+    int jobs;                /* modo lote: arquivos convertidos em paralelo */
+    int merge;               /* modo merge: todas as entradas num só --output */
+    const char *source_column; /* modo merge: coluna com o nome do arquivo de origem */
+    long long max_file_rows; /* modo merge: linhas por parte (0 = um arquivo só) */
     const char *encoding;    /* "auto" | "cp1252" | "cp850" | ... */
     int encoding_strict;     /* 0/1 */
     int batch_size;          /* default 100000 */
+    long long row_group_bytes; /* > 0: lote pelo tamanho em bytes (batch_size = amostra) */
     int keep_deleted;        /* 0(skip) / 1(keep) */
+    int threads;             /* threads de decodificação (default 1) */
+    int decimal;             /* N(w,d) como decimal128 em vez de double */
+    ConvDictMode dictionary; /* colunas texto como dictionary<int32, utf8> */
+    ConvInferMode infer;     /* tipo das colunas inteiras */
+    const char *columns;     /* projeção: só estas colunas, nesta ordem (NULL = todas) */
+    const char *exclude;     /* colunas fora da saída */
+    GPtrArray *where;        /* expressões --where (optarg, unidas por AND) */
+    AwWriteOpts write;       /* codec e tamanhos de página do Parquet */
+    GArray *column_codecs;   /* AwColumnCodec de --column-compression */
+    const char *incremental; /* arquivo de estado: só os registros novos, numa parte nova */
+    int resume;              /* segmentos + journal em <saída>.partial, retomável */
+    const char *stats;       /* relatório JSON de tempos e contadores ("-" = stdout) */
 } Cli;
 
 static void print_help() {
     printf(
-"Converte arquivos DBF/DBC para Parquet (Snappy), mapeando tipos diretamente.\n\n"
+"Converte arquivos DBF/DBC para Parquet (Snappy por default), mapeando tipos diretamente.\n\n"
 "Uso:\n"
-"  dbf2parquet --input <arquivo.dbf|dbc> --output <arquivo.parquet> [opções]\n\n"
+"  dbf2parquet --input <arquivo.dbf|dbc> --output <arquivo.parquet> [opções]\n"
+"  dbf2parquet --input-dir <DIR> | --input-glob <PADRÃO> | --input-list <ARQ>\n"
+"              --output-dir <DIR> [--jobs N] [opções]\n"
+"  dbf2parquet --merge --input-dir <DIR> | --input-glob <PADRÃO> | --input-list <ARQ>\n"
+"              --output <arquivo.parquet> [--source-column NOME] [--max-file-rows N]\n\n"
 "Opções:\n"
 "  --input <PATH>            DBF de entrada (ou DBC; requer .dbt/.fpt para MEMO)\n"
 "  --output <PATH>           Parquet de saída\n"
 "  --encoding <LABEL>        'auto' (default), cp1252, cp850, cp437, cp1250, cp1251, utf-8\n"
 "  --encoding-strict         Falha ao primeiro byte inválido na conversão para UTF-8\n"
 "  --batch-size <N>          Linhas por lote/row-group (default: 100000)\n"
+"  --row-group-bytes <N>     Row groups de ~N bytes descomprimidos (sufixos K, M, G),\n"
+"                            com linhas por lote estimadas dos tipos e de uma amostra\n"
+"                            de --batch-size registros de cada arquivo\n"
 "  --deleted <skip|keep>     Ignorar (default) ou incluir registros deletados\n"
+"  --threads <N>             Threads decodificando lotes em paralelo (default: 1;\n"
+"                            0 = nº de CPUs). Saída idêntica ao modo com 1 thread\n"
+"  --decimal                 Campos N(w,d) com casas decimais como decimal128(w-1,d),\n"
+"                            exatos, em vez de double (w <= 20). Valor com mais\n"
+"                            dígitos que a precisão vira NULL (erro com --encoding-strict)\n"
+"  --dictionary <MODO>       Texto como dicionário (índices int32 + valores distintos):\n"
+"                            'auto' (default: colunas de baixa cardinalidade no\n"
+"                            1º lote), 'always' ou 'never'\n"
+"  --infer <MODO>            Tipo dos campos inteiros (N/F sem decimais):\n"
+"                            'width' (default: campos N em int8/16/32/64 pela largura\n"
+"                            declarada, F em int64; valor que não cabe, como um\n"
+"                            expoente, vira NULL), 'sample' (pela faixa de valores\n"
+"                            do 1º lote; valor fora dela depois aborta com código 9)\n"
+"                            ou 'none' (sempre int64, como antes)\n"
+"  --columns <A,B,...>       Só estas colunas, nesta ordem (as demais não são lidas)\n"
+"  --exclude <A,B,...>       Todas menos estas colunas\n"
+"  --where <EXPR>            Só as linhas que satisfazem EXPR, testada nos bytes crus\n"
+"                            antes de decodificar (repetível; unidas por AND):\n"
+"                            COL = v, != <, <=, >, >=, COL IN (v1,v2), COL BETWEEN\n"
+"                            v1 AND v2, COL LIKE 'pref%%'. Datas AAAAMMDD ou AAAA-MM-DD\n"
+"  --compression <CODEC>     Codec das colunas: snappy (default), zstd, gzip, brotli,\n"
+"                            lz4 ou none\n"
+"  --column-compression <COL=CODEC>\n"
+"                            Codec de uma coluna (repetível), ex.: DIAG_PRINC=zstd\n"
+"  --data-page-size <BYTES>  Tamanho alvo das páginas de dados (default do Parquet: 1 MiB)\n"
+"  --dictionary-page-size <BYTES>\n"
+"                            Limite da página de dicionário; acima dele a coluna\n"
+"                            volta a PLAIN (default do Parquet: 1 MiB)\n"
+"  --incremental <ESTADO>    Tabela que só cresce: converte só os registros acrescentados\n"
+"                            desde a última execução numa parte nova\n"
+"                            (<saída>-00001.parquet, -00002, ...). O estado guarda a\n"
+"                            contagem, a data do cabeçalho, o schema e um hash do prefixo\n"
+"                            já convertido; prefixo alterado aborta com código 10\n"
+"                            (só .dbf; --infer sample vale como width)\n"
+"  --resume                  Conversão retomável: cada lote é gravado num segmento em\n"
+"                            <saída>.partial/ com um journal do registro alcançado;\n"
+"                            rodar de novo depois de uma interrupção continua dali.\n"
+"                            No fim os segmentos viram <saída> (rename atômico)\n"
+"  --stats <ARQ|->           Relatório JSON da execução em ARQ (ou no stdout): tempo\n"
+"                            de parede e de CPU por etapa, bytes lidos e gravados,\n"
+"                            linhas lidas/deletadas/filtradas/gravadas, textos\n"
+"                            transcodificados e com '?', row groups, taxa de\n"
+"                            compressão e pico de memória\n"
+"\nModo lote (um Parquet por entrada, vários arquivos num só processo):\n"
+"  --input-dir <DIR>         Todos os .dbf/.dbc de DIR (sem subdiretórios)\n"
+"  --input-glob <PADRÃO>     Arquivos cujo nome casa com o padrão (ex.: 'dados/*.dbc')\n"
+"  --input-list <ARQ>        Um caminho por linha (linhas vazias e '#' ignoradas)\n"
+"  --output-dir <DIR>        Diretório das saídas (<nome>.parquet; criado se preciso)\n"
+"  --jobs <N>                Arquivos convertidos em paralelo (default: nº de CPUs)\n"
+"\nModo merge (todas as entradas do modo lote num só dataset, uma leitura por arquivo):\n"
+"  --merge                   Junta as entradas em --output, na ordem em que são listadas.\n"
+"                            Schemas unificados pelo nome da coluna; tipos divergentes\n"
+"                            são alargados (inteiros → o mais largo; outros numéricos\n"
+"                            → double; demais → texto)\n"
+"  --source-column <NOME>    Acrescenta coluna texto com o nome do arquivo de origem\n"
+"  --max-file-rows <N>       Divide a saída em partes de até N linhas\n"
+"                            (<saída>-00001.parquet, <saída>-00002.parquet, ...)\n"
 "  -h, --help                Mostrar ajuda\n"
     );
 }
 
+/* Tamanho em bytes, com sufixo opcional K, M ou G (potências de 1024). 0 ok, -1 inválido. */
+static int parse_bytes(const char *s, long long *out) {
+    char *end = NULL;
+    long long v = strtoll(s, &end, 10);
+    if (end == s || v <= 0) return -1;
+    int shift = 0;
+    switch (*end) {
+        case '\0':           break;
+        case 'k': case 'K':  shift = 10; end++; break;
+        case 'm': case 'M':  shift = 20; end++; break;
+        case 'g': case 'G':  shift = 30; end++; break;
+        default:             return -1;
+    }
+    if (*end || v > (LLONG_MAX >> shift)) return -1;
+    *out = v << shift;
+    return 0;
+}
+
 static int parse_cli(int argc, char **argv, Cli *cli) {
     static struct option long_opts[] = {
         {"input", required_argument, 0, 0},
@@ -75,16 +154,60 @@ static int parse_cli(int argc, char **argv, Cli *cli) {
         {"encoding", required_argument, 0, 0},
         {"encoding-strict", no_argument, 0, 0},
         {"batch-size", required_argument, 0, 0},
+        {"row-group-bytes", required_argument, 0, 0},
         {"deleted", required_argument, 0, 0},
+        {"threads", required_argument, 0, 0},
+        {"decimal", no_argument, 0, 0},
+        {"dictionary", required_argument, 0, 0},
+        {"infer", required_argument, 0, 0},
+        {"columns", required_argument, 0, 0},
+        {"exclude", required_argument, 0, 0},
+        {"where", required_argument, 0, 0},
+        {"compression", required_argument, 0, 0},
+        {"column-compression", required_argument, 0, 0},
+        {"data-page-size", required_argument, 0, 0},
+        {"dictionary-page-size", required_argument, 0, 0},
+        {"input-dir", required_argument, 0, 0},
+        {"input-glob", required_argument, 0, 0},
+        {"input-list", required_argument, 0, 0},
+        {"output-dir", required_argument, 0, 0},
+        {"jobs", required_argument, 0, 0},
+        {"merge", no_argument, 0, 0},
+        {"source-column", required_argument, 0, 0},
+        {"max-file-rows", required_argument, 0, 0},
+        {"incremental", required_argument, 0, 0},
+        {"resume", no_argument, 0, 0},
+        {"stats", required_argument, 0, 0},
         {"help", no_argument, 0, 'h'},
         {0,0,0,0}
     };
     cli->input = NULL;
     cli->output = NULL;
+    cli->input_dir = NULL;
+    cli->input_glob = NULL;
+    cli->input_list = NULL;
+    cli->output_dir = NULL;
+    cli->jobs = 0;
+    cli->merge = 0;
+    cli->source_column = NULL;
+    cli->max_file_rows = 0;
     cli->encoding = "auto";
     cli->encoding_strict = 0;
     cli->batch_size = 100000;
+    cli->row_group_bytes = 0;
     cli->keep_deleted = 0;
+    cli->threads = 1;
+    cli->decimal = 0;
+    cli->dictionary = CONV_DICT_AUTO;
+    cli->infer = CONV_INFER_WIDTH;
+    cli->columns = NULL;
+    cli->exclude = NULL;
+    cli->where = g_ptr_array_new();
+    aw_write_opts_init(&cli->write);
+    cli->column_codecs = g_array_new(FALSE, TRUE, sizeof(AwColumnCodec));
+    cli->incremental = NULL;
+    cli->resume = 0;
+    cli->stats = NULL;
 
     int opt, idx;
     while ((opt = getopt_long(argc, argv, "h", long_opts, &idx)) != -1) {
@@ -96,6 +219,65 @@ static int parse_cli(int argc, char **argv, Cli *cli) {
             else if (strcmp(name, "encoding")==0) cli->encoding = optarg;
             else if (strcmp(name, "encoding-strict")==0) cli->encoding_strict = 1;
             else if (strcmp(name, "batch-size")==0) cli->batch_size = atoi(optarg);
+            else if (strcmp(name, "row-group-bytes")==0) {
+                if (parse_bytes(optarg, &cli->row_group_bytes) != 0) {
+                    fprintf(stderr, "Valor inválido para --row-group-bytes: %s\n", optarg);
+                    return -1;
+                }
+            }
+            else if (strcmp(name, "threads")==0) cli->threads = atoi(optarg);
+            else if (strcmp(name, "decimal")==0) cli->decimal = 1;
+            else if (strcmp(name, "columns")==0) cli->columns = optarg;
+            else if (strcmp(name, "exclude")==0) cli->exclude = optarg;
+            else if (strcmp(name, "where")==0) g_ptr_array_add(cli->where, optarg);
+            else if (strcmp(name, "input-dir")==0) cli->input_dir = optarg;
+            else if (strcmp(name, "input-glob")==0) cli->input_glob = optarg;
+            else if (strcmp(name, "input-list")==0) cli->input_list = optarg;
+            else if (strcmp(name, "output-dir")==0) cli->output_dir = optarg;
+            else if (strcmp(name, "jobs")==0) cli->jobs = atoi(optarg);
+            else if (strcmp(name, "merge")==0) cli->merge = 1;
+            else if (strcmp(name, "source-column")==0) cli->source_column = optarg;
+            else if (strcmp(name, "max-file-rows")==0) cli->max_file_rows = atoll(optarg);
+            else if (strcmp(name, "incremental")==0) cli->incremental = optarg;
+            else if (strcmp(name, "resume")==0) cli->resume = 1;
+            else if (strcmp(name, "stats")==0) cli->stats = optarg;
+            else if (strcmp(name, "dictionary")==0) {
+                if (strcmp(optarg, "auto")==0) cli->dictionary = CONV_DICT_AUTO;
+                else if (strcmp(optarg, "always")==0) cli->dictionary = CONV_DICT_ALWAYS;
+                else if (strcmp(optarg, "never")==0) cli->dictionary = CONV_DICT_NEVER;
+                else { fprintf(stderr, "Valor inválido para --dictionary: %s\n", optarg); return -1; }
+            }
+            else if (strcmp(name, "infer")==0) {
+                if (strcmp(optarg, "width")==0) cli->infer = CONV_INFER_WIDTH;
+                else if (strcmp(optarg, "sample")==0) cli->infer = CONV_INFER_SAMPLE;
+                else if (strcmp(optarg, "none")==0) cli->infer = CONV_INFER_NONE;
+                else { fprintf(stderr, "Valor inválido para --infer: %s\n", optarg); return -1; }
+            }
+            else if (strcmp(name, "compression")==0) {
+                if (aw_parse_compression(optarg, &cli->write.compression) != 0) {
+                    fprintf(stderr, "Valor inválido para --compression: %s\n", optarg);
+                    return -1;
+                }
+            }
+            else if (strcmp(name, "column-compression")==0) {
+                const char *eq = strchr(optarg, '=');
+                AwColumnCodec cc;
+                if (!eq || eq == optarg || aw_parse_compression(eq + 1, &cc.codec) != 0) {
+                    fprintf(stderr, "Valor inválido para --column-compression (COL=CODEC): %s\n", optarg);
+                    return -1;
+                }
+                cc.column = g_strndup(optarg, (gsize)(eq - optarg));
+                g_array_append_val(cli->column_codecs, cc);
+            }
+            else if (strcmp(name, "data-page-size")==0 || strcmp(name, "dictionary-page-size")==0) {
+                long long v;
+                if (parse_bytes(optarg, &v) != 0) {
+                    fprintf(stderr, "Valor inválido para --%s: %s\n", name, optarg);
+                    return -1;
+                }
+                if (strcmp(name, "data-page-size")==0) cli->write.data_page_size = v;
+                else cli->write.dictionary_page_size = v;
+            }
             else if (strcmp(name, "deleted")==0) {
                 if (strcmp(optarg, "keep")==0) cli->keep_deleted = 1;
                 else if (strcmp(optarg, "skip")==0) cli->keep_deleted = 0;
@@ -104,143 +286,627 @@ static int parse_cli(int argc, char **argv, Cli *cli) {
         }
     }
 
-    if (!cli->input || !cli->output) {
+    if (cli->batch_size <= 0) {
+        fprintf(stderr, "Valor inválido para --batch-size: deve ser > 0\n");
+        return -1;
+    }
+
+    cli->write.column_codecs  = (const AwColumnCodec*)cli->column_codecs->data;
+    cli->write.ncolumn_codecs = (int)cli->column_codecs->len;
+
+    if (cli->threads < 0) {
+        fprintf(stderr, "Valor inválido para --threads: deve ser >= 0\n");
+        return -1;
+    }
+    if (cli->threads == 0) cli->threads = (int)g_get_num_processors();
+
+    if (cli->jobs < 0) {
+        fprintf(stderr, "Valor inválido para --jobs: deve ser >= 0\n");
+        return -1;
+    }
+    if (cli->jobs == 0) cli->jobs = (int)g_get_num_processors();
+
+    if (cli->max_file_rows < 0) {
+        fprintf(stderr, "Valor inválido para --max-file-rows: deve ser >= 0\n");
+        return -1;
+    }
+
+    int batch = cli->input_dir || cli->input_glob || cli->input_list;
+    if ((cli->incremental || cli->resume) && (batch || cli->merge)) {
+        fprintf(stderr, "--incremental/--resume só valem com --input/--output (um arquivo)\n");
+        return -1;
+    }
+    if (cli->incremental && cli->resume) {
+        fprintf(stderr, "--incremental e --resume não se combinam\n");
+        return -1;
+    }
+    if (cli->merge) {
+        if (!batch || cli->input || cli->output_dir || !cli->output) {
+            fprintf(stderr, "--merge requer --input-dir/--input-glob/--input-list e --output "
+                            "(sem --input/--output-dir)\n");
+            return -1;
+        }
+        return 0;
+    }
+    if (cli->source_column || cli->max_file_rows) {
+        fprintf(stderr, "--source-column/--max-file-rows só valem com --merge\n");
+        return -1;
+    }
+    if (batch && (cli->input || cli->output)) {
+        fprintf(stderr, "--input/--output não se combinam com --input-dir/--input-glob/--input-list\n");
+        return -1;
+    }
+    if (batch ? !cli->output_dir : (!cli->input || !cli->output)) {
         print_help();
         return -1;
     }
     return 0;
 }
 
-static const char* resolve_codepage(const char *dbf_path, const char *encoding_cli) {
-    if (encoding_cli && strcasecmp(encoding_cli, "auto") != 0) return encoding_cli;
-    unsigned char ldid = 0;
-    if (read_ldid_byte(dbf_path, &ldid) == 0) {
-        const char *cp = ldid_to_codepage(ldid);
-        if (cp) return cp;
+/* Mensagem de erro para o chamador (impressa no modo de um arquivo, guardada
+   para o resumo no modo lote) */
+static int fail(char *msg, size_t msglen, int rc, const char *fmt, ...) G_GNUC_PRINTF(4, 5);
+static int fail(char *msg, size_t msglen, int rc, const char *fmt, ...) {
+    va_list ap;
+    va_start(ap, fmt);
+    vsnprintf(msg, msglen, fmt, ap);
+    va_end(ap);
+    return rc;
+}
+
+static void conv_opts_from_cli(const Cli *cli, ConvOpts *opts) {
+    opts->batch_size   = cli->batch_size;
+    opts->row_group_bytes = cli->row_group_bytes;
+    opts->where        = NULL;
+    opts->keep_deleted = cli->keep_deleted;
+    opts->strict       = cli->encoding_strict;
+    opts->threads      = cli->threads;
+    opts->first_row    = 0;
+    opts->stats        = NULL;
+}
+
+/* Cada lote vira um row group do writer */
+static int write_to_parquet(void *user, GArrowRecordBatch *batch) {
+    return aw_write_batch((GParquetArrowFileWriter*)user, batch);
+}
+
+/* --incremental: o arquivo ainda é o que gerou as partes anteriores (mesmo
+   layout, prefixo já convertido intacto)? Retorna 0 ok ou o código de saída. */
+static int inc_check_prefix(const DbfCtx *ctx, const IncState *inc, char *msg, size_t msglen) {
+    if (ctx->header_len != inc->header_len || ctx->record_len != inc->record_len)
+        return fail(msg, msglen, 10, "--incremental: layout do arquivo mudou desde a última execução "
+                    "(apague o estado para reconverter do início).");
+    if (ctx->nrecords < inc->records)
+        return fail(msg, msglen, 10, "--incremental: arquivo tem %d registros, menos que os %lld já "
+                    "convertidos (apague o estado para reconverter do início).", ctx->nrecords, inc->records);
+    if (inc_hash_records(ctx, 0, (int)inc->records, INC_HASH_SEED) != inc->prefix_hash)
+        return fail(msg, msglen, 10, "--incremental: registros já convertidos foram alterados "
+                    "(apague o estado para reconverter do início).");
+    return 0;
+}
+
+/* --resume: staging e journal de uma conversão (ver resume.h) */
+typedef struct {
+    const char    *input;
+    char          *staging;    /* <saída>.partial */
+    ResumeJournal  journal;    /* rows = 0 e schema NULL: conversão nova */
+    GArrowSchema  *schema;     /* dos segmentos */
+    char           msg[256];   /* erro gravando o journal */
+} ResumeRun;
+
+/* Cada lote vira um segmento completo (com footer); lote vazio não gera arquivo */
+static int resume_write(void *user, GArrowRecordBatch *batch) {
+    ResumeRun *r = (ResumeRun*)user;
+    gint64 nrows = garrow_record_batch_get_n_rows(batch);
+    if (nrows == 0) return 0;
+    if (r->journal.segments == 0 && g_mkdir_with_parents(r->staging, 0755) != 0) return -1;
+    char *path = res_segment_path(r->staging, r->journal.segments + 1);
+    /* staging com os defaults (Snappy): o codec pedido é aplicado na cópia final */
+    GParquetArrowFileWriter *w = aw_open_parquet(path, r->schema, NULL);
+    g_free(path);
+    if (!w) return -1;
+    if (aw_write_batch(w, batch) != 0) {
+        g_object_unref(w);
+        return -1;
     }
-    return "CP1252";
+    if (aw_close_parquet(w) != 0) return -1;
+    r->journal.segments++;
+    r->journal.emitted += nrows;
+    return 0;
 }
 
-int main(int argc, char **argv) {
-    Cli cli;
-    if (parse_cli(argc, argv, &cli) != 0) return 2;
-
-    char tmp_dbf[4096] = {0};
-    const char *in_path = cli.input;
-
-    /* Detecta extensão .dbc (case-insensitive) */
-    /* Detecta .dbc e extrai */
-    const char *dot = strrchr(cli.input, '.');
-    if (dot) {
-        char ext[8]; size_t n = 0;
-        for (const char *p = dot + 1; *p && n < sizeof(ext)-1; ++p)
-            ext[n++] = (char)tolower((unsigned char)*p);
-        ext[n] = '\0';
-
-        if (strcmp(ext, "dbc") == 0) {
-            /* Sempre salve temporário com .dbf (shapelib gosta de extensão certa) */
-            if (join_with_ext(tmp_dbf, sizeof(tmp_dbf), cli.output, ".dbf") != 0) {
-                fprintf(stderr, "Caminho muito longo ao criar temporário .dbf\n");
-                return 3;
-            }
-            fprintf(stderr, "Detectado .dbc, descompactando para: %s\n", tmp_dbf);
-
-            /* 1) Tenta usar dbc2dbf local */
-            char cmd[8192];
-            int rc;
-            rc = snprintf(cmd, sizeof(cmd), "./dbc2dbf '%s' '%s'", cli.input, tmp_dbf);
-            if (rc < 0 || (size_t)rc >= sizeof(cmd)) { fprintf(stderr, "Comando muito longo\n"); return 3; }
-            rc = system(cmd);
-
-            /* 2) Fallback: dbc2dbf do PATH */
-            if (rc != 0) {
-                rc = snprintf(cmd, sizeof(cmd), "dbc2dbf '%s' '%s'", cli.input, tmp_dbf);
-                if (rc < 0 || (size_t)rc >= sizeof(cmd)) { fprintf(stderr, "Comando muito longo\n"); return 3; }
-                rc = system(cmd);
-            }
+/* Segmento no disco: o journal passa a apontar depois do lote */
+static int resume_checkpoint(void *user, int next_row) {
+    ResumeRun *r = (ResumeRun*)user;
+    r->journal.rows = next_row;
+    return res_save(r->staging, &r->journal, r->input, r->msg, sizeof(r->msg));
+}
 
-            /* 3) Se ainda falhar, tente heurística de “arquivo já extraído” ao lado do .dbc */
-            if (rc != 0) {
-                char base[PATH_MAX];
-                size_t len = (size_t)(dot - cli.input);
-                if (len >= sizeof(base)) { fprintf(stderr, "Caminho base muito longo\n"); return 3; }
-                memcpy(base, cli.input, len);
-                base[len] = '\0';
-
-                char cand1[PATH_MAX], cand2[PATH_MAX];
-                int ok1 = (join_with_ext(cand1, sizeof(cand1), base, ".DBF") == 0);
-                int ok2 = (join_with_ext(cand2, sizeof(cand2), base, ".dbf") == 0);
-
-                int copied = 0;
-                if (ok1 && access(cand1, R_OK) == 0 && copy_file(cand1, tmp_dbf) == 0) copied = 1;
-                else if (ok2 && access(cand2, R_OK) == 0 && copy_file(cand2, tmp_dbf) == 0) copied = 1;
-
-                if (!copied) {
-                    fprintf(stderr,
-                            "Falha ao descompactar .dbc e não encontrei .DBF ao lado.\n"
-                            "Verifique se 'dbc2dbf' está no mesmo diretório ou no PATH.\n");
-                    return 3;
-                }
-            }
+/* Opções que mudam o conteúdo das linhas: um journal gravado com outras não
+   pode ser continuado (g_free) */
+static char* resume_options(const Cli *cli, const char *from_cp) {
+    GString *o = g_string_new(NULL);
+    g_string_append_printf(o, "encoding=%s strict=%d deleted=%s where=", from_cp,
+                           cli->encoding_strict, cli->keep_deleted ? "keep" : "skip");
+    for (guint i = 0; i < cli->where->len; i++)
+        g_string_append_printf(o, "%s(%s)", i ? " AND " : "", (const char*)g_ptr_array_index(cli->where, i));
+    return g_string_free(o, FALSE);
+}
 
-            in_path = tmp_dbf;
-        }
+/* O journal pode ser continuado com esta entrada e estas opções? Preenche a
+   identificação da entrada no journal. Retorna 0 ok ou o código de saída. */
+static int resume_check(const Cli *cli, const char *from_cp, const DbfCtx *ctx, ResumeRun *r,
+                        char *msg, size_t msglen) {
+    ResumeJournal cur;
+    memset(&cur, 0, sizeof(cur));
+    if (res_identify(r->input, ctx, &cur) != 0)
+        return fail(msg, msglen, 4, "Erro lendo os atributos de %s.", r->input);
+    char *options = resume_options(cli, from_cp);
+    if (r->journal.schema && (!res_same_input(&r->journal, &cur) || strcmp(r->journal.options, options) != 0)) {
+        g_free(options);
+        return fail(msg, msglen, 10, "--resume: entrada ou opções diferentes das da conversão "
+                    "interrompida (apague %s para recomeçar).", r->staging);
     }
+    res_identify(r->input, ctx, &r->journal);
+    g_free(r->journal.options);
+    r->journal.options = options;
+    return 0;
+}
 
+/* Conversão completa: segmentos copiados em ordem para <saída>.tmp, renomeado
+   para <saída>; o staging só é apagado depois do rename */
+static int resume_finish(const Cli *cli, ResumeRun *r, const char *output, GArrowSchema *schema,
+                         char *msg, size_t msglen) {
+    char *tmp = g_strdup_printf("%s.tmp", output);
+    GParquetArrowFileWriter *writer = aw_open_parquet(tmp, schema, &cli->write);
+    int rc = writer ? 0 : -1;
+    for (int s = 1; rc == 0 && s <= r->journal.segments; s++) {
+        char *seg = res_segment_path(r->staging, s);
+        rc = aw_append_parquet(writer, seg);
+        g_free(seg);
+    }
+    if (writer) {
+        if (rc == 0) rc = aw_close_parquet(writer);
+        else g_object_unref(writer);
+    }
+    if (rc == 0 && g_rename(tmp, output) != 0) rc = -1;
+    if (rc != 0) {
+        remove(tmp);
+        g_free(tmp);
+        return fail(msg, msglen, 7, "Falha ao escrever Parquet (os segmentos continuam em %s).", r->staging);
+    }
+    g_free(tmp);
+    res_remove_staging(r->staging, r->journal.segments);
+    return 0;
+}
+
+/* Converte um DBF/DBC em um Parquet. Retorna o código de saída (0 ok) e, em
+   erro, a mensagem em `msg`. `verbose` imprime encoding e avisos.
+   Com `inc` (--incremental), converte só os registros depois de inc->records,
+   com o schema das partes anteriores, e atualiza *inc em caso de sucesso;
+   sem registros novos não grava `output` (*records = 0).
+   Com `res` (--resume), os lotes vão para os segmentos do staging, a partir
+   de res->journal.rows, e `output` só aparece no fim, por rename.
+   Com `st` (--stats), soma ali os tempos das etapas e os contadores. */
+static int convert_file(const Cli *cli, const char *input, const char *output, int verbose,
+                        IncState *inc, ResumeRun *res, RunStats *st,
+                        char *msg, size_t msglen, long long *records) {
+    msg[0] = '\0';
+    *records = 0;
+    StageMark mark = stats_begin();
+    if (st) {
+        st->files++;
+        st->bytes_read += stats_file_size(input);
+    }
+
+    /* .dbc: descompactado em memória enquanto converte */
+    int is_dbc = dbc_is_dbc_path(input);
+    if (inc && is_dbc)
+        return fail(msg, msglen, 2, "--incremental: só arquivos .dbf (um .dbc é recompactado inteiro).");
+
+    const char *from_cp = enc_resolve_codepage(input, cli->encoding);
+    if (verbose) fprintf(stderr, "Encoding: %s (strict=%d)\n", from_cp, cli->encoding_strict);
 
-    const char *from_cp = resolve_codepage(in_path, cli.encoding);
-    fprintf(stderr, "Encoding: %s (strict=%d)\n", from_cp, cli.encoding_strict);
+    /* Codepage resolvida uma vez; cada thread de decodificação monta seu EncCtx */
+    EncCtx enc;
+    if (enc_open(&enc, from_cp) != 0)
+        return fail(msg, msglen, 4, "Sem memória para o conversor de encoding.");
+    if (enc_is_passthrough(&enc))
+        fprintf(stderr, "Aviso: %s: codepage '%s' não suportada; strings copiadas sem conversão.\n",
+                input, from_cp);
+    enc_close(&enc);
 
     DbfCtx ctx;
     ColumnSpec *cols = NULL;
-    if (dbf_open(in_path, &ctx, &cols) != 0) {
-        fprintf(stderr, "Erro abrindo DBF.\n");
-        if (tmp_dbf[0]) remove(tmp_dbf);
-        return 4;
+    int orc = is_dbc ? dbc_open(input, &ctx, &cols) : dbf_open(input, &ctx, &cols);
+    if (st) stats_end(&st->open, mark);
+    if (orc != 0)
+        return fail(msg, msglen, 4, is_dbc ? "Erro abrindo DBC." : "Erro abrindo DBF.");
+    mark = stats_begin();
+
+    if (inc && inc->parts > 0) {
+        int irc = inc_check_prefix(&ctx, inc, msg, msglen);
+        if (irc == 0 && ctx.nrecords == inc->records && verbose)
+            fprintf(stderr, "Nenhum registro novo desde a última execução (%lld).\n", inc->records);
+        if (irc != 0 || ctx.nrecords == inc->records) {
+            dbf_close(&ctx);
+            free(cols);
+            return irc;
+        }
+    }
+    if (inc && inc->parts == 0 && ctx.nrecords == 0) {
+        /* sem registros não há estado a salvar: não abre a parte (ficaria órfã) */
+        if (verbose) fprintf(stderr, "Nenhum registro em %s; nada gravado.\n", input);
+        dbf_close(&ctx);
+        free(cols);
+        return 0;
+    }
+    if (res) {
+        int rrc = resume_check(cli, from_cp, &ctx, res, msg, msglen);
+        if (rrc != 0) {
+            dbf_close(&ctx);
+            free(cols);
+            return rrc;
+        }
     }
 
-    /* Schema Arrow */
-    GArrowSchema *schema = aw_build_schema(cols, ctx.nfields);
-
-    /* Loop por lotes → cria builders, append linhas, finish em RecordBatch, acumula e escreve */
-    GPtrArray *batches = g_ptr_array_new_with_free_func(g_object_unref);
-    int row = 0;
-    while (row < ctx.nrecords) {
-        GPtrArray *builders = NULL;
-        aw_make_builders(schema, &builders);
-
-        int appended = 0;
-        for (; row < ctx.nrecords && appended < cli.batch_size; row++) {
-            int del = dbf_is_deleted(&ctx, row);
-            if (del < 0) { fprintf(stderr, "Erro lendo flag deleted.\n"); dbf_close(&ctx); return 5; }
-            if (!cli.keep_deleted && del == 1) continue;
-
-            if (aw_append_row(builders, cols, ctx.nfields, &ctx, row, from_cp, cli.encoding_strict) != 0) {
-                fprintf(stderr, "Erro de conversão (encoding strict?) na linha %d.\n", row);
-                dbf_close(&ctx);
-                if (tmp_dbf[0]) remove(tmp_dbf);
-                return 6;
-            }
-            appended++;
+    /* filtro compilado contra o layout completo (pode usar colunas fora da projeção) */
+    WhereFilter *where = NULL;
+    if (cli->where->len) {
+        char wmsg[256];
+        where = where_compile((char**)cli->where->pdata, (int)cli->where->len, cols, ctx.nfields,
+                              from_cp, 0, wmsg, sizeof(wmsg));
+        if (!where) {
+            dbf_close(&ctx);
+            free(cols);
+            return fail(msg, msglen, 2, "%s", wmsg);
         }
+    }
 
-        GArrowRecordBatch *batch = aw_finish_batch(schema, builders);
-        g_ptr_array_add(batches, batch);
-        g_ptr_array_free(builders, TRUE);
+    /* projeção antes da amostra: colunas fora dela nem são lidas */
+    int ncols = ctx.nfields;
+    char bad[64];
+    if (conv_project(cols, &ncols, cli->columns, cli->exclude, bad, sizeof(bad)) != 0) {
+        where_free(where);
+        dbf_close(&ctx);
+        free(cols);
+        if (!bad[0]) return fail(msg, msglen, 2, "--columns/--exclude: nenhuma coluna selecionada.");
+        return fail(msg, msglen, 2, "--columns/--exclude: coluna inexistente ou repetida: %s", bad);
     }
 
-    if (aw_write_parquet(cli.output, schema, batches) != 0) {
-        fprintf(stderr, "Falha ao escrever Parquet.\n");
+    if (cli->decimal) dbf_map_decimals(cols, ncols);
+
+    /* --incremental/--resume: o schema das partes/segmentos já gravados (sem
+       amostrar de novo) */
+    const char *saved = inc && inc->parts > 0 ? inc->schema : res ? res->journal.schema : NULL;
+    if (saved) {
+        if (inc_apply_schema(saved, cols, ncols) != 0) {
+            where_free(where);
+            dbf_close(&ctx);
+            free(cols);
+            return fail(msg, msglen, 10, "%s: colunas diferentes das já gravadas "
+                        "(outras opções de --columns/--decimal?).", inc ? "--incremental" : "--resume");
+        }
+    }
+    /* inteiros estreitados e dicionário: amostra do 1º lote (numa stream ele é
+       guardado e reaproveitado pelo conv_run). Incremental: a faixa de registros
+       futuros é desconhecida, então sample vale como width */
+    else if (conv_infer_ints(&ctx, cols, ncols,
+                             inc && cli->infer == CONV_INFER_SAMPLE ? CONV_INFER_WIDTH : cli->infer,
+                             cli->batch_size) != 0 ||
+             conv_choose_dictionary(&ctx, cols, ncols, cli->dictionary, cli->batch_size) != 0) {
+        where_free(where);
         dbf_close(&ctx);
-        if (tmp_dbf[0]) remove(tmp_dbf);
-        return 7;
+        free(cols);
+        return fail(msg, msglen, 5, "Erro lendo registros a partir da linha 0.");
+    }
+    if (verbose) {
+        int ndict = 0;
+        for (int i = 0; i < ncols; i++) {
+            if (!cols[i].dict) continue;
+            fprintf(stderr, ndict++ ? ", %s" : "Dicionário: %s", cols[i].name);
+        }
+        if (ndict) fprintf(stderr, "\n");
+    }
+
+    /* Schema Arrow */
+    GArrowSchema *schema = aw_build_schema(cols, ncols);
+    if (res && !res->journal.schema) res->journal.schema = inc_schema_string(cols, ncols);
+
+    /* Writer aberto uma vez: cada lote vira um row group assim que é finalizado,
+       então a memória depende de --batch-size (ou --row-group-bytes) e não do
+       tamanho do arquivo */
+    if (verbose) {
+        int u = aw_unknown_codec_column(&cli->write, cols, ncols);
+        if (u >= 0)
+            fprintf(stderr, "Aviso: --column-compression %s: coluna inexistente.\n",
+                    cli->write.column_codecs[u].column);
+    }
+    GParquetArrowFileWriter *writer = res ? NULL : aw_open_parquet(output, schema, &cli->write);
+    if (!res && !writer) {
+        g_object_unref(schema);
+        where_free(where);
+        dbf_close(&ctx);
+        free(cols);
+        return fail(msg, msglen, 7, "Falha ao escrever Parquet.");
+    }
+
+    /* Lotes de registros → flags de deletado de uma vez, decodificação colunar
+       das linhas ativas direto em buffers Arrow, RecordBatch e escrita em ordem */
+    if (st) stats_end(&st->prepare, mark);
+    ConvOpts opts;
+    conv_opts_from_cli(cli, &opts);
+    opts.where = where;
+    opts.stats = st ? &st->conv : NULL;
+    if (inc) opts.first_row = (int)inc->records;
+    ConvSink sink = { write_to_parquet, writer, NULL };
+    if (res) {
+        res->schema = schema;
+        opts.first_row = (int)res->journal.rows;
+        sink = (ConvSink){ resume_write, res, resume_checkpoint };
+    }
+
+    int err_row = -1;
+    int rc = conv_run(&ctx, cols, ncols, schema, from_cp, &sink, &opts, &err_row);
+    switch (rc) {
+        case CONV_OK: break;
+        case CONV_ERR_DELETED:
+            if (err_row >= 0) fail(msg, msglen, rc, "Erro lendo registros a partir da linha %d.", err_row);
+            else              fail(msg, msglen, rc, "Erro lendo flag deleted.");
+            break;
+        case CONV_ERR_ENCODING:
+            fail(msg, msglen, rc, "Erro de conversão (--encoding-strict: byte inválido, decimal acima da precisão ou inteiro acima da largura) na linha %d.", err_row);
+            break;
+        case CONV_ERR_RANGE:
+            fail(msg, msglen, rc, "Inteiro fora da faixa da amostra de --infer sample na linha %d (use --infer width).",
+                 err_row);
+            break;
+        default:
+            fail(msg, msglen, rc, "%s", res && res->msg[0] ? res->msg : "Falha ao escrever Parquet.");
+            break;
+    }
+
+    mark = stats_begin();
+    if (res) {
+        if (rc == 0) rc = resume_finish(cli, res, output, schema, msg, msglen);
+        else if (verbose)
+            fprintf(stderr, "--resume: %lld registros já convertidos em %s; rode de novo para continuar.\n",
+                    res->journal.rows, res->staging);
+    } else if (rc == 0) {
+        if (aw_close_parquet(writer) != 0)
+            rc = fail(msg, msglen, 7, "Falha ao escrever Parquet.");
+    } else {
+        g_object_unref(writer);
+    }
+    if (rc != 0 && !res) remove(output); /* não deixa Parquet truncado (sem footer) */
+    if (rc == 0) *records = ctx.nrecords - opts.first_row;
+    if (st) {
+        stats_end(&st->close, mark);
+        if (rc == 0) st->bytes_written += stats_file_size(output);
+    }
+
+    if (rc == 0 && inc) {
+        /* hash continuado: cobre [0, nrecords) sem reler o prefixo */
+        inc->prefix_hash = inc_hash_records(&ctx, opts.first_row, ctx.nrecords - opts.first_row,
+                                            inc->parts > 0 ? inc->prefix_hash : INC_HASH_SEED);
+        inc->records    = ctx.nrecords;
+        inc->parts++;
+        inc->header_len = ctx.header_len;
+        inc->record_len = ctx.record_len;
+        inc_header_date(&ctx, inc->header_date);
+        g_free(inc->schema);
+        inc->schema = inc_schema_string(cols, ncols);
     }
 
-    g_ptr_array_free(batches, TRUE);
     g_object_unref(schema);
+    where_free(where);
     dbf_close(&ctx);
     free(cols);
 
-    if (tmp_dbf[0]) remove(tmp_dbf); /* limpa temporário */
-    return 0;
+    return rc;
+}
+
+/* Modo lote: opções e totais compartilhados pelos workers */
+typedef struct {
+    const Cli *cli;
+    RunStats  *stats;        /* --stats: soma de todos os arquivos (NULL = não mede) */
+    GMutex     lock;
+} BatchRun;
+
+/* Worker do modo lote */
+static void convert_item(BatchItem *item, void *user) {
+    BatchRun *b = (BatchRun*)user;
+    RunStats st;
+    memset(&st, 0, sizeof(st));
+    item->rc = convert_file(b->cli, item->input, item->output, 0, NULL, NULL, b->stats ? &st : NULL,
+                            item->msg, sizeof(item->msg), &item->records);
+    if (b->stats) {
+        g_mutex_lock(&b->lock);
+        stats_add_run(b->stats, &st);
+        g_mutex_unlock(&b->lock);
+    }
+}
+
+/* Entradas do modo lote/merge (NULL se nenhuma ou erro, já reportado) */
+static GPtrArray* collect_inputs(const Cli *cli) {
+    GPtrArray *paths = g_ptr_array_new_with_free_func(g_free);
+    if (batch_collect(cli->input_dir, cli->input_glob, cli->input_list, paths) != 0) {
+        g_ptr_array_free(paths, TRUE);
+        return NULL;
+    }
+    if (paths->len == 0) {
+        fprintf(stderr, "Nenhum arquivo de entrada encontrado.\n");
+        g_ptr_array_free(paths, TRUE);
+        return NULL;
+    }
+    return paths;
+}
+
+/* Modo lote: todas as entradas num só processo, `--jobs` arquivos por vez */
+static int run_batch(const Cli *cli, RunStats *st) {
+    GPtrArray *paths = collect_inputs(cli);
+    if (!paths) return 2;
+
+    int n = 0;
+    BatchItem *items = batch_items(paths, cli->output_dir, &n);
+    g_ptr_array_free(paths, TRUE);
+    if (!items) return 2;
+
+    fprintf(stderr, "Convertendo %d arquivos com %d jobs (encoding %s, strict=%d)\n",
+            n, cli->jobs < n ? cli->jobs : n, cli->encoding, cli->encoding_strict);
+    BatchRun b;
+    b.cli = cli;
+    b.stats = st;
+    g_mutex_init(&b.lock);
+    batch_run(items, n, cli->jobs, convert_item, &b);
+    g_mutex_clear(&b.lock);
+
+    int failed = batch_report(items, n, stderr);
+    batch_free(items, n);
+    return failed ? 8 : 0;
+}
+
+/* Modo merge: todas as entradas em ordem num só dataset (um writer) */
+static int run_merge(const Cli *cli, RunStats *st) {
+    GPtrArray *paths = collect_inputs(cli);
+    if (!paths) return 2;
+
+    MergeOpts mo;
+    mo.output        = cli->output;
+    mo.max_rows      = cli->max_file_rows;
+    mo.source_column = cli->source_column;
+    mo.encoding      = cli->encoding;
+    mo.decimal       = cli->decimal;
+    mo.dictionary    = cli->dictionary;
+    mo.infer         = cli->infer;
+    mo.columns       = cli->columns;
+    mo.exclude       = cli->exclude;
+    mo.where         = (char**)cli->where->pdata;
+    mo.nwhere        = (int)cli->where->len;
+    mo.write         = &cli->write;
+    mo.verbose       = 1;
+    mo.stats         = st;
+
+    ConvOpts opts;
+    conv_opts_from_cli(cli, &opts);
+    opts.stats = st ? &st->conv : NULL;
+
+    fprintf(stderr, "Juntando %u arquivos em %s (strict=%d)\n",
+            paths->len, cli->output, cli->encoding_strict);
+    char msg[256];
+    long long records = 0;
+    int rc = merge_run((char**)paths->pdata, (int)paths->len, &mo, &opts, msg, sizeof(msg), &records);
+    if (rc != 0) fprintf(stderr, "%s\n", msg);
+    else fprintf(stderr, "%lld registros lidos de %u arquivos\n", records, paths->len);
+    g_ptr_array_free(paths, TRUE);
+    return rc;
+}
+
+/* --incremental: registros novos de --input em <saída>-NNNNN.parquet e
+   estado atualizado só depois da parte gravada (falha = nada muda) */
+static int run_incremental(const Cli *cli, RunStats *stats) {
+    char msg[256];
+    IncState st;
+    if (inc_load(cli->incremental, &st, msg, sizeof(msg)) != 0) {
+        fprintf(stderr, "%s\n", msg);
+        return 2;
+    }
+    if (st.parts > 0)
+        fprintf(stderr, "Estado: %lld registros em %d partes (cabeçalho de %s)\n",
+                st.records, st.parts, st.header_date);
+
+    char *part = aw_part_path(cli->output, st.parts + 1);
+    long long records = 0;
+    int rc = convert_file(cli, cli->input, part, 1, &st, NULL, stats, msg, sizeof(msg), &records);
+    if (rc != 0) {
+        fprintf(stderr, "%s\n", msg);
+    } else if (records > 0) {
+        if (inc_save(cli->incremental, &st, cli->input, msg, sizeof(msg)) != 0) {
+            fprintf(stderr, "%s\n", msg);
+            remove(part); /* sem estado, a parte seria gravada de novo na próxima execução */
+            rc = 7;
+        } else {
+            fprintf(stderr, "%lld registros novos em %s\n", records, part);
+        }
+    }
+    g_free(part);
+    inc_clear(&st);
+    return rc;
+}
+
+/* --resume: continua a conversão interrompida de --input, se houver staging */
+static int run_resume(const Cli *cli, RunStats *st) {
+    ResumeRun r;
+    memset(&r, 0, sizeof(r));
+    r.input = cli->input;
+    r.staging = res_staging_dir(cli->output);
+
+    char msg[256];
+    int rc = 0;
+    if (res_load(r.staging, &r.journal, msg, sizeof(msg)) != 0) {
+        fprintf(stderr, "%s\n", msg);
+        rc = 10;
+    } else {
+        if (r.journal.schema)
+            fprintf(stderr, "Retomando do registro %lld (%d segmentos em %s)\n",
+                    r.journal.rows, r.journal.segments, r.staging);
+        long long records = 0;
+        rc = convert_file(cli, cli->input, cli->output, 1, NULL, &r, st, msg, sizeof(msg), &records);
+        if (rc != 0) fprintf(stderr, "%s\n", msg);
+    }
+    res_clear(&r.journal);
+    g_free(r.staging);
+    return rc;
+}
+
+static void cli_clear(Cli *cli) {
+    for (guint i = 0; i < cli->column_codecs->len; i++)
+        g_free(g_array_index(cli->column_codecs, AwColumnCodec, i).column);
+    g_array_free(cli->column_codecs, TRUE);
+    g_ptr_array_free(cli->where, TRUE);
+}
+
+/* --stats: fecha os totais da execução e grava o JSON (falha só avisa: a
+   conversão em si já terminou) */
+static void write_stats(const Cli *cli, RunStats *st, double start, int rc) {
+    st->mode = cli->merge ? "merge" : !cli->input ? "batch" :
+               cli->incremental ? "incremental" : cli->resume ? "resume" : "single";
+    st->input = cli->input;
+    st->output = cli->input || cli->merge ? cli->output : cli->output_dir;
+    st->exit_code = rc;
+    st->total.wall = stats_wall() - start;
+    st->total.cpu = stats_process_cpu();
+    st->peak_rss = stats_peak_rss();
+    if (stats_write_json(st, cli->stats) != 0)
+        fprintf(stderr, "Aviso: --stats: não foi possível gravar %s.\n", cli->stats);
+}
+
+int main(int argc, char **argv) {
+    double start = stats_wall();
+    Cli cli;
+    RunStats stats;
+    memset(&stats, 0, sizeof(stats));
+    int rc;
+    if (parse_cli(argc, argv, &cli) != 0) {
+        cli_clear(&cli);
+        return 2;
+    }
+    RunStats *st = cli.stats ? &stats : NULL;
+    if (cli.merge) {
+        rc = run_merge(&cli, st);
+    } else if (!cli.input) {
+        rc = run_batch(&cli, st);
+    } else if (cli.incremental) {
+        rc = run_incremental(&cli, st);
+    } else if (cli.resume) {
+        rc = run_resume(&cli, st);
+    } else {
+        char msg[256];
+        long long records = 0;
+        rc = convert_file(&cli, cli.input, cli.output, 1, NULL, NULL, st, msg, sizeof(msg), &records);
+        if (rc != 0) fprintf(stderr, "%s\n", msg);
+    }
+    if (st) write_stats(&cli, st, start, rc);
+    cli_clear(&cli);
+    return rc;
 }
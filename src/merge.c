@@ -0,0 +1,330 @@
+#include "merge.h"
+#include "dbc_reader.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <glib.h>
+
+static int merge_fail(char *msg, size_t msglen, int rc, const char *fmt, ...) G_GNUC_PRINTF(4, 5);
+static int merge_fail(char *msg, size_t msglen, int rc, const char *fmt, ...) {
+    va_list ap;
+    va_start(ap, fmt);
+    vsnprintf(msg, msglen, fmt, ap);
+    va_end(ap);
+    return rc;
+}
+
+static int is_numeric(ColKind k) {
+    return dbf_kind_is_int(k) || k == COL_FLOAT64 || k == COL_DECIMAL128;
+}
+
+/* Ordem de largura dos inteiros */
+static int int_rank(ColKind k) {
+    switch (k) {
+        case COL_INT8:  return 0;
+        case COL_INT16: return 1;
+        case COL_INT32: return 2;
+        default:        return 3;
+    }
+}
+
+/* Tipo comum de duas versões da mesma coluna */
+static ColKind widen_kind(ColKind a, ColKind b) {
+    if (a == b) return a;
+    if (dbf_kind_is_int(a) && dbf_kind_is_int(b)) return int_rank(a) > int_rank(b) ? a : b;
+    if (is_numeric(a) && is_numeric(b)) return COL_FLOAT64;
+    return COL_UTF8;
+}
+
+static int find_col(const GArray *cols, const char *name) {
+    for (guint i = 0; i < cols->len; i++)
+        if (strcmp(g_array_index(cols, ColumnSpec, i).name, name) == 0) return (int)i;
+    return -1;
+}
+
+/* Passe 1: só os headers. Preenche `unified` (ColumnSpec, offset sem uso). */
+static int unify_schemas(char **inputs, int n, const MergeOpts *mo, GArray *unified, char *msg, size_t msglen) {
+    for (int f = 0; f < n; f++) {
+        DbfCtx hdr;
+        ColumnSpec *cols = NULL;
+        if (dbf_read_header(inputs[f], &hdr, &cols) != 0)
+            return merge_fail(msg, msglen, 4, "%s: erro lendo o cabeçalho.", inputs[f]);
+        if (mo->decimal) dbf_map_decimals(cols, hdr.nfields);
+        /* amostra de um arquivo não vale para os outros: SAMPLE fica na largura */
+        if (mo->infer != CONV_INFER_NONE) dbf_narrow_ints(cols, hdr.nfields);
+
+        for (int i = 0; i < hdr.nfields; i++) {
+            int u = find_col(unified, cols[i].name);
+            if (u < 0) {
+                g_array_append_val(unified, cols[i]);
+                continue;
+            }
+            ColumnSpec *c = &g_array_index(unified, ColumnSpec, u);
+            ColKind k = widen_kind(c->kind, cols[i].kind);
+            if (k != c->kind && k == COL_UTF8)
+                fprintf(stderr, "Aviso: coluna %s com tipos diferentes ('%c' e '%c' em %s); gravada como texto.\n",
+                        c->name, c->type, cols[i].type, inputs[f]);
+            if (k == COL_DECIMAL128) {
+                /* precisão cobre a maior parte inteira com a maior escala */
+                int ints = c->width - c->decimals;
+                if (cols[i].width - cols[i].decimals > ints) ints = cols[i].width - cols[i].decimals;
+                if (cols[i].decimals > c->decimals) c->decimals = cols[i].decimals;
+                c->width = ints + c->decimals;
+            } else {
+                if (cols[i].width > c->width)       c->width = cols[i].width;
+                if (cols[i].decimals > c->decimals) c->decimals = cols[i].decimals;
+            }
+            c->kind = k;
+        }
+        free(cols);
+    }
+    return 0;
+}
+
+/* --- destino: um arquivo, ou partes de até max_rows linhas --- */
+typedef struct {
+    const MergeOpts         *mo;
+    GArrowSchema            *schema;
+    GParquetArrowFileWriter *writer;     /* parte aberta (NULL = nenhuma) */
+    long long                part_rows;  /* linhas já na parte aberta */
+    GPtrArray               *parts;      /* caminhos criados (g_free) */
+} MergeSink;
+
+static char* part_path(const MergeOpts *mo, int part) {
+    if (mo->max_rows <= 0) return g_strdup(mo->output);
+    return aw_part_path(mo->output, part);
+}
+
+static int sink_open_part(MergeSink *s) {
+    char *path = part_path(s->mo, (int)s->parts->len + 1);
+    s->writer = aw_open_parquet(path, s->schema, s->mo->write);
+    if (!s->writer) { g_free(path); return -1; }
+    g_ptr_array_add(s->parts, path);
+    s->part_rows = 0;
+    return 0;
+}
+
+static int sink_close_part(MergeSink *s) {
+    GParquetArrowFileWriter *w = s->writer;
+    s->writer = NULL;
+    return aw_close_parquet(w);
+}
+
+static int merge_write(void *user, GArrowRecordBatch *batch) {
+    MergeSink *s = (MergeSink*)user;
+    gint64 n = garrow_record_batch_get_n_rows(batch);
+    gint64 off = 0;
+    while (off < n) {
+        if (!s->writer && sink_open_part(s) != 0) return -1;
+
+        gint64 take = n - off;
+        if (s->mo->max_rows > 0 && take > s->mo->max_rows - s->part_rows)
+            take = s->mo->max_rows - s->part_rows;
+
+        /* lote inteiro cabe na parte: sem fatiar; senão fatia zero-copy */
+        int rc;
+        if (off == 0 && take == n) {
+            rc = aw_write_batch(s->writer, batch);
+        } else {
+            GArrowRecordBatch *piece = garrow_record_batch_slice(batch, off, take);
+            rc = aw_write_batch(s->writer, piece);
+            g_object_unref(piece);
+        }
+        if (rc != 0) return -1;
+
+        s->part_rows += take;
+        off += take;
+        if (s->mo->max_rows > 0 && s->part_rows >= s->mo->max_rows && sink_close_part(s) != 0)
+            return -1;
+    }
+    return 0;
+}
+
+/* Colunas de um arquivo na ordem do schema unificado: tipo unificado com
+   offset/largura/tipo nativo do arquivo; ausentes viram colunas nulas */
+static ColumnSpec* file_view(const GArray *unified, const ColumnSpec *cols, int nfields,
+                             const char *source_value) {
+    ColumnSpec *view = (ColumnSpec*)calloc(unified->len ? unified->len : 1, sizeof(ColumnSpec));
+    if (!view) return NULL;
+    for (guint u = 0; u < unified->len; u++) {
+        view[u] = g_array_index(unified, ColumnSpec, u);
+        view[u].offset = -1;
+        view[u].value  = NULL;
+        for (int i = 0; i < nfields; i++) {
+            if (strcmp(cols[i].name, view[u].name) != 0) continue;
+            /* decimal: escala e precisão da coluna unificada (o parser reescala e
+               confere contra o schema de saída); a largura do arquivo só recorta o campo */
+            if (view[u].kind == COL_DECIMAL128) view[u].precision = dbf_decimal_precision(&view[u]);
+            else view[u].decimals = cols[i].decimals;
+            view[u].width    = cols[i].width;
+            view[u].type     = cols[i].type;
+            view[u].offset   = cols[i].offset;
+            break;
+        }
+    }
+    /* a coluna de origem é sempre a última */
+    if (source_value) view[unified->len - 1].value = source_value;
+    return view;
+}
+
+static int conv_error(int rc, int err_row, const char *input, char *msg, size_t msglen) {
+    switch (rc) {
+        case CONV_ERR_DELETED:
+            if (err_row >= 0)
+                return merge_fail(msg, msglen, rc, "%s: erro lendo registros a partir da linha %d.", input, err_row);
+            return merge_fail(msg, msglen, rc, "%s: erro lendo flag deleted.", input);
+        case CONV_ERR_ENCODING:
+            return merge_fail(msg, msglen, rc, "%s: erro de conversão (--encoding-strict: byte inválido, decimal acima da precisão ou inteiro acima da largura) na linha %d.", input, err_row);
+        case CONV_ERR_RANGE:
+            return merge_fail(msg, msglen, rc, "%s: inteiro fora da faixa da amostra de --infer sample na linha %d.", input, err_row);
+        default:
+            return merge_fail(msg, msglen, rc, "%s: falha ao escrever Parquet.", input);
+    }
+}
+
+int merge_run(char **inputs, int n, const MergeOpts *mo, const ConvOpts *co,
+              char *msg, size_t msglen, long long *records) {
+    msg[0] = '\0';
+    *records = 0;
+    RunStats *rs = mo->stats;
+
+    StageMark mark = stats_begin();
+    GArray *unified = g_array_new(FALSE, TRUE, sizeof(ColumnSpec));
+    int rc = unify_schemas(inputs, n, mo, unified, msg, msglen);
+    if (rc == 0 && mo->nwhere > 0) {
+        /* nomes, sintaxe e valores conferidos uma vez, antes de ler registros e
+           antes da projeção (o filtro pode usar colunas fora dela) */
+        WhereFilter *w = where_compile(mo->where, mo->nwhere, (const ColumnSpec*)unified->data,
+                                       (int)unified->len, enc_resolve_codepage(inputs[0], mo->encoding),
+                                       0, msg, msglen);
+        if (!w) rc = 2;
+        where_free(w);
+    }
+    if (rc == 0) {
+        int m = (int)unified->len;
+        char bad[64];
+        if (conv_project((ColumnSpec*)unified->data, &m, mo->columns, mo->exclude, bad, sizeof(bad)) != 0)
+            rc = bad[0] ? merge_fail(msg, msglen, 2, "--columns/--exclude: coluna inexistente ou repetida: %s", bad)
+                        : merge_fail(msg, msglen, 2, "--columns/--exclude: nenhuma coluna selecionada.");
+        else
+            g_array_set_size(unified, (guint)m);
+    }
+    if (rc == 0 && mo->source_column) {
+        if (strlen(mo->source_column) >= sizeof(((ColumnSpec*)0)->name)) {
+            rc = merge_fail(msg, msglen, 2, "Nome longo demais para --source-column: %s", mo->source_column);
+        } else if (find_col(unified, mo->source_column) >= 0) {
+            rc = merge_fail(msg, msglen, 2, "--source-column %s: já existe uma coluna com esse nome.",
+                            mo->source_column);
+        } else {
+            ColumnSpec src;
+            memset(&src, 0, sizeof(src));
+            g_strlcpy(src.name, mo->source_column, sizeof(src.name));
+            src.kind   = COL_UTF8;
+            src.type   = 'C';
+            src.offset = -1;
+            g_array_append_val(unified, src);
+        }
+    }
+    if (rc != 0) {
+        g_array_free(unified, TRUE);
+        return rc;
+    }
+    int ncols = (int)unified->len;
+    if (rs) stats_end(&rs->prepare, mark);
+
+    MergeSink sink;
+    memset(&sink, 0, sizeof(sink));
+    sink.mo     = mo;
+    sink.parts  = g_ptr_array_new_with_free_func(g_free);
+    ConvSink cs = { merge_write, &sink, NULL };
+
+    /* Passe 2: as entradas em ordem, num só fluxo de row groups */
+    for (int f = 0; rc == 0 && f < n; f++) {
+        const char *input = inputs[f];
+        const char *from_cp = enc_resolve_codepage(input, mo->encoding);
+        if (mo->verbose)
+            fprintf(stderr, "[%d/%d] %s (encoding %s)\n", f + 1, n, input, from_cp);
+
+        DbfCtx ctx;
+        ColumnSpec *cols = NULL;
+        int is_dbc = dbc_is_dbc_path(input);
+        if (rs) {
+            rs->files++;
+            rs->bytes_read += stats_file_size(input);
+        }
+        mark = stats_begin();
+        int orc = is_dbc ? dbc_open(input, &ctx, &cols) : dbf_open(input, &ctx, &cols);
+        if (rs) stats_end(&rs->open, mark);
+        if (orc != 0) {
+            rc = merge_fail(msg, msglen, 4, "%s: erro abrindo %s.", input, is_dbc ? "DBC" : "DBF");
+            break;
+        }
+
+        char *source = mo->source_column ? g_path_get_basename(input) : NULL;
+        ColumnSpec *view = file_view(unified, cols, ctx.nfields, source);
+        if (!view) {
+            rc = merge_fail(msg, msglen, 5, "Sem memória.");
+        } else if (f == 0) {
+            /* dicionário decidido pela amostra do 1º arquivo; schema só depois */
+            if (conv_choose_dictionary(&ctx, view, ncols, mo->dictionary, co->batch_size) != 0) {
+                rc = merge_fail(msg, msglen, 5, "%s: erro lendo registros.", input);
+            } else {
+                for (int u = 0; u < ncols; u++) g_array_index(unified, ColumnSpec, u).dict = view[u].dict;
+                sink.schema = aw_build_schema((const ColumnSpec*)unified->data, ncols);
+                int u = mo->write ? aw_unknown_codec_column(mo->write, (const ColumnSpec*)unified->data, ncols) : -1;
+                if (u >= 0 && mo->verbose)
+                    fprintf(stderr, "Aviso: --column-compression %s: coluna inexistente.\n",
+                            mo->write->column_codecs[u].column);
+            }
+        }
+        ConvOpts fco = *co;
+        if (rc == 0 && view && mo->nwhere > 0) {
+            fco.where = where_compile(mo->where, mo->nwhere, cols, ctx.nfields, from_cp, 1, msg, msglen);
+            if (!fco.where) rc = 2;
+        }
+        if (rc == 0 && view) {
+            int err_row = -1;
+            int crc = conv_run(&ctx, view, ncols, sink.schema, from_cp, &cs, &fco, &err_row);
+            if (crc != CONV_OK) rc = conv_error(crc, err_row, input, msg, msglen);
+            else *records += ctx.nrecords;
+        }
+
+        where_free((WhereFilter*)fco.where);
+        free(view);
+        g_free(source);
+        dbf_close(&ctx);
+        free(cols);
+    }
+
+    /* nenhum registro: ainda assim um Parquet (vazio) com o schema */
+    if (rc == 0 && sink.parts->len == 0 && sink_open_part(&sink) != 0)
+        rc = merge_fail(msg, msglen, 7, "Falha ao escrever Parquet.");
+
+    if (sink.writer) {
+        if (rc == 0) {
+            mark = stats_begin();
+            if (sink_close_part(&sink) != 0) rc = merge_fail(msg, msglen, 7, "Falha ao escrever Parquet.");
+            if (rs) stats_end(&rs->close, mark);
+        } else {
+            g_object_unref(sink.writer);
+            sink.writer = NULL;
+        }
+    }
+    if (rc == 0) {
+        if (mo->verbose && mo->max_rows > 0)
+            fprintf(stderr, "%u partes de até %lld linhas\n", sink.parts->len, mo->max_rows);
+        for (guint i = 0; rs && i < sink.parts->len; i++)
+            rs->bytes_written += stats_file_size(g_ptr_array_index(sink.parts, i));
+    } else {
+        if (!msg[0]) merge_fail(msg, msglen, rc, "Falha ao escrever Parquet.");
+        /* não deixa dataset parcial (nem parte truncada sem footer) */
+        for (guint i = 0; i < sink.parts->len; i++) remove(g_ptr_array_index(sink.parts, i));
+    }
+
+    g_ptr_array_free(sink.parts, TRUE);
+    if (sink.schema) g_object_unref(sink.schema);
+    g_array_free(unified, TRUE);
+    return rc;
+}
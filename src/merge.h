@@ -0,0 +1,39 @@
+#ifndef MERGE_H
+#define MERGE_H
+
+#include <stddef.h>
+#include "convert.h"
+
+/* Modo merge: várias entradas (mesmo layout, ex. um arquivo por UF) num único
+   dataset Parquet, lendo cada entrada uma vez */
+typedef struct {
+    const char *output;        /* Parquet de saída (com max_rows: base dos nomes das partes) */
+    long long   max_rows;      /* > 0: nova parte a cada max_rows linhas (<base>-00001.parquet, ...) */
+    const char *source_column; /* coluna UTF-8 com o nome do arquivo de origem (NULL = sem) */
+    const char *encoding;      /* "auto" ou label, resolvida por arquivo */
+    int         decimal;       /* N(w,d) como decimal128 (dbf_map_decimals) */
+    ConvDictMode dictionary;   /* AUTO: amostra do 1º arquivo */
+    ConvInferMode infer;       /* NONE: int64; WIDTH e SAMPLE: pela largura (só headers) */
+    const char *columns;       /* projeção sobre o schema unificado (conv_project) */
+    const char *exclude;
+    char      **where;         /* --where: validado no schema unificado, compilado por arquivo */
+    int         nwhere;
+    const AwWriteOpts *write;  /* codec/páginas de todas as partes (NULL = defaults) */
+    int         verbose;       /* progresso por arquivo no stderr */
+    RunStats   *stats;         /* --stats: etapas fora do conv_run, bytes e arquivos (NULL = não
+                                  mede; os contadores do conv_run vão em co->stats) */
+} MergeOpts;
+
+/* Unifica os schemas das entradas (colunas pelo nome, na ordem em que aparecem;
+   coluna ausente num arquivo fica nula nas linhas dele) e alarga tipos que
+   divergem: inteiros de larguras diferentes → o inteiro mais largo; decimais
+   com escalas diferentes → a maior escala; outras misturas de numéricos
+   (inteiros/FLOAT64/DECIMAL128) → FLOAT64; qualquer outra → UTF8
+   (texto do campo). Aplica --columns/--exclude ao schema unificado;
+   o --where é compilado por arquivo (arquivo sem a coluna: nenhuma linha passa). Depois converte as entradas em ordem com conv_run(), cada
+   lote um row group da saída. Retorna o código de saída (0 ok) e, em erro, a mensagem em
+   `msg`; nenhuma parte é deixada no disco. *records = registros lidos. */
+int merge_run(char **inputs, int n, const MergeOpts *mo, const ConvOpts *co,
+              char *msg, size_t msglen, long long *records);
+
+#endif
@@ -0,0 +1,128 @@
+#include "resume.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <glib.h>
+#include <glib/gstdio.h>
+
+#define RES_GROUP   "dbf2parquet-resume"
+#define RES_JOURNAL "journal"
+
+static int res_fail(char *msg, size_t msglen, const char *fmt, ...) G_GNUC_PRINTF(3, 4);
+static int res_fail(char *msg, size_t msglen, const char *fmt, ...) {
+    va_list ap;
+    va_start(ap, fmt);
+    vsnprintf(msg, msglen, fmt, ap);
+    va_end(ap);
+    return -1;
+}
+
+char* res_staging_dir(const char *output) {
+    return g_strdup_printf("%s.partial", output);
+}
+
+char* res_segment_path(const char *dir, int segment) {
+    return g_strdup_printf("%s%cseg-%05d.parquet", dir, G_DIR_SEPARATOR, segment);
+}
+
+int res_load(const char *dir, ResumeJournal *j, char *msg, size_t msglen) {
+    memset(j, 0, sizeof(*j));
+    char *path = g_build_filename(dir, RES_JOURNAL, NULL);
+    if (!g_file_test(path, G_FILE_TEST_EXISTS)) {
+        g_free(path);
+        return 0;
+    }
+
+    GKeyFile *kf = g_key_file_new();
+    GError *error = NULL;
+    int rc = 0;
+    if (!g_key_file_load_from_file(kf, path, G_KEY_FILE_NONE, &error)) {
+        rc = res_fail(msg, msglen, "%s: journal ilegível: %s", path, error->message);
+        g_error_free(error);
+    } else {
+        j->rows        = (long long)g_key_file_get_int64(kf, RES_GROUP, "rows", NULL);
+        j->emitted     = (long long)g_key_file_get_int64(kf, RES_GROUP, "emitted", NULL);
+        j->segments    = g_key_file_get_integer(kf, RES_GROUP, "segments", NULL);
+        j->header_len  = (long)g_key_file_get_int64(kf, RES_GROUP, "header_len", NULL);
+        j->record_len  = (long)g_key_file_get_int64(kf, RES_GROUP, "record_len", NULL);
+        j->nrecords    = (long long)g_key_file_get_int64(kf, RES_GROUP, "nrecords", NULL);
+        j->input_size  = (long long)g_key_file_get_int64(kf, RES_GROUP, "input_size", NULL);
+        j->input_mtime = (long long)g_key_file_get_int64(kf, RES_GROUP, "input_mtime", NULL);
+        j->schema      = g_key_file_get_string(kf, RES_GROUP, "schema", NULL);
+        j->options     = g_key_file_get_string(kf, RES_GROUP, "options", NULL);
+        if (!j->schema || !j->options || j->segments < 0 || j->rows < 0 || j->emitted > j->rows) {
+            rc = res_fail(msg, msglen, "%s: journal incompleto (apague %s para recomeçar).", path, dir);
+            res_clear(j);
+        }
+    }
+    g_key_file_free(kf);
+    g_free(path);
+    return rc;
+}
+
+int res_save(const char *dir, const ResumeJournal *j, const char *input, char *msg, size_t msglen) {
+    if (g_mkdir_with_parents(dir, 0755) != 0)
+        return res_fail(msg, msglen, "%s: não foi possível criar o diretório de staging.", dir);
+
+    GKeyFile *kf = g_key_file_new();
+    g_key_file_set_string(kf, RES_GROUP, "input", input);
+    g_key_file_set_int64(kf, RES_GROUP, "rows", j->rows);
+    g_key_file_set_int64(kf, RES_GROUP, "emitted", j->emitted);
+    g_key_file_set_integer(kf, RES_GROUP, "segments", j->segments);
+    g_key_file_set_int64(kf, RES_GROUP, "header_len", j->header_len);
+    g_key_file_set_int64(kf, RES_GROUP, "record_len", j->record_len);
+    g_key_file_set_int64(kf, RES_GROUP, "nrecords", j->nrecords);
+    g_key_file_set_int64(kf, RES_GROUP, "input_size", j->input_size);
+    g_key_file_set_int64(kf, RES_GROUP, "input_mtime", j->input_mtime);
+    g_key_file_set_string(kf, RES_GROUP, "schema", j->schema ? j->schema : "");
+    g_key_file_set_string(kf, RES_GROUP, "options", j->options ? j->options : "");
+
+    /* temporário + rename: uma interrupção nunca deixa o journal pela metade */
+    char *path = g_build_filename(dir, RES_JOURNAL, NULL);
+    GError *error = NULL;
+    int rc = 0;
+    if (!g_key_file_save_to_file(kf, path, &error)) {
+        rc = res_fail(msg, msglen, "%s: erro gravando o journal: %s", path, error->message);
+        g_error_free(error);
+    }
+    g_free(path);
+    g_key_file_free(kf);
+    return rc;
+}
+
+int res_identify(const char *input, const DbfCtx *ctx, ResumeJournal *j) {
+    GStatBuf st;
+    if (g_stat(input, &st) != 0) return -1;
+    j->header_len  = ctx->header_len;
+    j->record_len  = ctx->record_len;
+    j->nrecords    = ctx->nrecords;
+    j->input_size  = (long long)st.st_size;
+    j->input_mtime = (long long)st.st_mtime;
+    return 0;
+}
+
+int res_same_input(const ResumeJournal *a, const ResumeJournal *b) {
+    return a->header_len == b->header_len && a->record_len == b->record_len &&
+           a->nrecords == b->nrecords && a->input_size == b->input_size &&
+           a->input_mtime == b->input_mtime;
+}
+
+void res_remove_staging(const char *dir, int segments) {
+    for (int s = 1; s <= segments + 1; s++) {  /* +1: segmento interrompido antes do journal */
+        char *seg = res_segment_path(dir, s);
+        g_remove(seg);
+        g_free(seg);
+    }
+    char *path = g_build_filename(dir, RES_JOURNAL, NULL);
+    g_remove(path);
+    g_free(path);
+    g_rmdir(dir);
+}
+
+void res_clear(ResumeJournal *j) {
+    g_free(j->schema);
+    g_free(j->options);
+    memset(j, 0, sizeof(*j));
+}
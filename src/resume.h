@@ -0,0 +1,50 @@
+#ifndef RESUME_H
+#define RESUME_H
+
+#include <stddef.h>
+#include "dbf_reader.h"
+
+/* --resume: conversão que sobrevive a uma interrupção. Cada lote vira um
+   segmento Parquet completo (com footer) no diretório de staging
+   <saída>.partial/, e o journal é regravado depois de cada segmento. Ao
+   reiniciar, a conversão continua do registro salvo; no fim os segmentos
+   são copiados para <saída>.tmp, renomeado para <saída>. */
+typedef struct {
+    long long rows;         /* registros [0, rows) já convertidos (lotes inteiros) */
+    long long emitted;      /* linhas gravadas nos segmentos (rows - emitted:
+                               deletados pulados e filtrados por --where) */
+    int       segments;     /* seg-00001.parquet .. seg-<segments>.parquet */
+    long      header_len;   /* identificação da entrada: layout, nº de registros, */
+    long      record_len;   /* tamanho e data de modificação do arquivo */
+    long long nrecords;
+    long long input_size;
+    long long input_mtime;
+    char     *schema;       /* inc_schema_string() das colunas (g_free) */
+    char     *options;      /* opções que mudam o conteúdo das linhas (g_free) */
+} ResumeJournal;
+
+/* "<output>.partial" (g_free) */
+char* res_staging_dir(const char *output);
+
+/* "<dir>/seg-00001.parquet" (g_free) */
+char* res_segment_path(const char *dir, int segment);
+
+/* Lê o journal de `dir`. Sem staging = conversão nova (*j zerado).
+   Retorna 0 ok, -1 journal ilegível (mensagem em `msg`). */
+int res_load(const char *dir, ResumeJournal *j, char *msg, size_t msglen);
+
+/* Cria `dir` se preciso e regrava o journal de uma vez. 0 ok, -1 erro. */
+int res_save(const char *dir, const ResumeJournal *j, const char *input, char *msg, size_t msglen);
+
+/* Preenche a identificação da entrada em *j a partir do arquivo e de `ctx`. 0 ok, -1 stat falhou. */
+int res_identify(const char *input, const DbfCtx *ctx, ResumeJournal *j);
+
+/* Mesma entrada (layout, registros, tamanho e data) que a do journal? */
+int res_same_input(const ResumeJournal *a, const ResumeJournal *b);
+
+/* Apaga os segmentos, o journal e o diretório de staging. */
+void res_remove_staging(const char *dir, int segments);
+
+void res_clear(ResumeJournal *j);
+
+#endif
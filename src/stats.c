@@ -0,0 +1,198 @@
+#include "stats.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <glib.h>
+#include <glib/gstdio.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+double stats_wall(void) {
+    return (double)g_get_monotonic_time() / 1e6;
+}
+
+#ifdef _WIN32
+/* FILETIME de kernel + usuário, em segundos */
+static double filetime_secs(const FILETIME *k, const FILETIME *u) {
+    ULARGE_INTEGER a, b;
+    a.LowPart = k->dwLowDateTime; a.HighPart = k->dwHighDateTime;
+    b.LowPart = u->dwLowDateTime; b.HighPart = u->dwHighDateTime;
+    return (double)(a.QuadPart + b.QuadPart) / 1e7;   /* unidades de 100 ns */
+}
+
+double stats_thread_cpu(void) {
+    FILETIME c, e, k, u;
+    if (!GetThreadTimes(GetCurrentThread(), &c, &e, &k, &u)) return 0;
+    return filetime_secs(&k, &u);
+}
+
+double stats_process_cpu(void) {
+    FILETIME c, e, k, u;
+    if (!GetProcessTimes(GetCurrentProcess(), &c, &e, &k, &u)) return 0;
+    return filetime_secs(&k, &u);
+}
+
+long long stats_peak_rss(void) {
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) return 0;
+    return (long long)pmc.PeakWorkingSetSize;
+}
+#else
+static double clock_secs(clockid_t id) {
+    struct timespec ts;
+    if (clock_gettime(id, &ts) != 0) return 0;
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+double stats_thread_cpu(void) {
+    return clock_secs(CLOCK_THREAD_CPUTIME_ID);
+}
+
+double stats_process_cpu(void) {
+    return clock_secs(CLOCK_PROCESS_CPUTIME_ID);
+}
+
+long long stats_peak_rss(void) {
+    struct rusage ru;
+    if (getrusage(RUSAGE_SELF, &ru) != 0) return 0;
+#ifdef __APPLE__
+    return (long long)ru.ru_maxrss;          /* bytes */
+#else
+    return (long long)ru.ru_maxrss * 1024;   /* KiB */
+#endif
+}
+#endif
+
+StageMark stats_begin(void) {
+    StageMark m;
+    m.wall = stats_wall();
+    m.cpu = stats_thread_cpu();
+    return m;
+}
+
+void stats_end(StageTime *t, StageMark m) {
+    t->wall += stats_wall() - m.wall;
+    t->cpu += stats_thread_cpu() - m.cpu;
+}
+
+static void add_time(StageTime *dst, const StageTime *src) {
+    dst->wall += src->wall;
+    dst->cpu += src->cpu;
+}
+
+void stats_add_conv(ConvStats *dst, const ConvStats *src) {
+    add_time(&dst->fetch, &src->fetch);
+    add_time(&dst->decode, &src->decode);
+    add_time(&dst->write, &src->write);
+    dst->rows_read          += src->rows_read;
+    dst->rows_deleted       += src->rows_deleted;
+    dst->rows_filtered      += src->rows_filtered;
+    dst->rows_emitted       += src->rows_emitted;
+    dst->record_bytes       += src->record_bytes;
+    dst->row_groups         += src->row_groups;
+    dst->strings_transcoded += src->strings_transcoded;
+    dst->strings_replaced   += src->strings_replaced;
+}
+
+void stats_add_run(RunStats *dst, const RunStats *src) {
+    add_time(&dst->open, &src->open);
+    add_time(&dst->prepare, &src->prepare);
+    add_time(&dst->close, &src->close);
+    stats_add_conv(&dst->conv, &src->conv);
+    dst->bytes_read    += src->bytes_read;
+    dst->bytes_written += src->bytes_written;
+    dst->files         += src->files;
+}
+
+long long stats_file_size(const char *path) {
+    GStatBuf st;
+    return g_stat(path, &st) == 0 ? (long long)st.st_size : 0;
+}
+
+/* "texto" com as sequências de escape do JSON; NULL vira null */
+static void json_string(GString *out, const char *s) {
+    if (!s) {
+        g_string_append(out, "null");
+        return;
+    }
+    g_string_append_c(out, '"');
+    for (const unsigned char *p = (const unsigned char*)s; *p; p++) {
+        switch (*p) {
+            case '"':  g_string_append(out, "\\\""); break;
+            case '\\': g_string_append(out, "\\\\"); break;
+            case '\n': g_string_append(out, "\\n");  break;
+            case '\r': g_string_append(out, "\\r");  break;
+            case '\t': g_string_append(out, "\\t");  break;
+            default:
+                if (*p < 0x20) g_string_append_printf(out, "\\u%04x", *p);
+                else g_string_append_c(out, (char)*p);   /* UTF-8 passa como está */
+        }
+    }
+    g_string_append_c(out, '"');
+}
+
+static void json_stage(GString *out, const char *name, const StageTime *t, int last) {
+    g_string_append_printf(out, "    \"%s\": {\"wall_seconds\": %.6f, \"cpu_seconds\": %.6f}%s\n",
+                           name, t->wall, t->cpu, last ? "" : ",");
+}
+
+int stats_write_json(const RunStats *s, const char *path) {
+    const ConvStats *c = &s->conv;
+    GString *out = g_string_new("{\n");
+    g_string_append(out, "  \"version\": 1,\n  \"mode\": ");
+    json_string(out, s->mode);
+    g_string_append(out, ",\n  \"input\": ");
+    json_string(out, s->input);
+    g_string_append(out, ",\n  \"output\": ");
+    json_string(out, s->output);
+    g_string_append_printf(out, ",\n  \"exit_code\": %d,\n", s->exit_code);
+    g_string_append_printf(out, "  \"files\": %d,\n", s->files);
+    g_string_append_printf(out, "  \"wall_seconds\": %.6f,\n", s->total.wall);
+    g_string_append_printf(out, "  \"cpu_seconds\": %.6f,\n", s->total.cpu);
+    g_string_append_printf(out, "  \"peak_rss_bytes\": %lld,\n", s->peak_rss);
+
+    g_string_append(out, "  \"stages\": {\n");
+    json_stage(out, "open", &s->open, 0);
+    json_stage(out, "prepare", &s->prepare, 0);
+    json_stage(out, "fetch", &c->fetch, 0);
+    json_stage(out, "decode", &c->decode, 0);
+    json_stage(out, "write", &c->write, 0);
+    json_stage(out, "close", &s->close, 1);
+    g_string_append(out, "  },\n");
+
+    g_string_append_printf(out, "  \"bytes\": {\"read\": %lld, \"records\": %lld, \"written\": %lld},\n",
+                           s->bytes_read, c->record_bytes, s->bytes_written);
+    g_string_append_printf(out, "  \"rows\": {\"read\": %lld, \"deleted\": %lld, \"filtered\": %lld, "
+                           "\"emitted\": %lld},\n",
+                           c->rows_read, c->rows_deleted, c->rows_filtered, c->rows_emitted);
+    g_string_append_printf(out, "  \"strings\": {\"transcoded\": %lld, \"replaced\": %lld},\n",
+                           c->strings_transcoded, c->strings_replaced);
+    g_string_append_printf(out, "  \"row_groups\": %lld,\n", c->row_groups);
+    /* registros descompactados / Parquet gravado */
+    if (s->bytes_written > 0)
+        g_string_append_printf(out, "  \"compression_ratio\": %.3f\n",
+                               (double)c->record_bytes / (double)s->bytes_written);
+    else
+        g_string_append(out, "  \"compression_ratio\": null\n");
+    g_string_append(out, "}\n");
+
+    int rc = 0;
+    if (strcmp(path, "-") == 0) {
+        if (fwrite(out->str, 1, out->len, stdout) != out->len || fflush(stdout) != 0) rc = -1;
+    } else {
+        FILE *f = g_fopen(path, "wb");
+        if (!f) rc = -1;
+        else {
+            if (fwrite(out->str, 1, out->len, f) != out->len) rc = -1;
+            if (fclose(f) != 0) rc = -1;
+        }
+    }
+    g_string_free(out, TRUE);
+    return rc;
+}
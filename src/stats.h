@@ -0,0 +1,78 @@
+#ifndef STATS_H
+#define STATS_H
+
+/* --stats: tempos por etapa e contadores de uma execução, num documento JSON
+   para quem agenda as conversões acompanhar regressões e jobs mal dimensionados */
+
+/* Tempo acumulado de uma etapa, em segundos */
+typedef struct {
+    double wall;             /* relógio monotônico */
+    double cpu;              /* CPU da(s) thread(s) que executaram a etapa */
+} StageTime;
+
+/* Início de uma etapa na thread chamadora (stats_begin/stats_end) */
+typedef struct {
+    double wall;
+    double cpu;
+} StageMark;
+
+/* Relógio monotônico e CPU da thread chamadora, em segundos */
+double stats_wall(void);
+double stats_thread_cpu(void);
+
+/* CPU de todas as threads do processo (inclui a descompressão do .dbc) */
+double stats_process_cpu(void);
+
+/* Pico de memória residente do processo em bytes (0 = indisponível) */
+long long stats_peak_rss(void);
+
+StageMark stats_begin(void);
+
+/* Soma em *t o tempo decorrido desde `m` (na mesma thread de stats_begin) */
+void stats_end(StageTime *t, StageMark m);
+
+/* Contadores de conv_run(). Os tempos são somados entre as threads de
+   decodificação: com --threads N, fetch + decode pode passar do tempo total. */
+typedef struct {
+    StageTime fetch;              /* dbf_fetch: registros do lote (num .dbc, espera pela descompressão) */
+    StageTime decode;             /* deletados, --where, decodificação e transcodificação */
+    StageTime write;              /* sink: codificação e compressão Parquet, escrita */
+    long long rows_read;
+    long long rows_deleted;       /* pulados (--deleted skip) */
+    long long rows_filtered;      /* descartados pelo --where */
+    long long rows_emitted;
+    long long record_bytes;       /* bytes de registros lidos (descompactados) */
+    long long row_groups;         /* lotes não vazios entregues ao sink */
+    long long strings_transcoded; /* textos não-ASCII convertidos para UTF-8 (EncCtx) */
+    long long strings_replaced;   /* desses, com byte inválido trocado por '?' */
+} ConvStats;
+
+void stats_add_conv(ConvStats *dst, const ConvStats *src);
+
+/* Uma execução do dbf2parquet: um arquivo, o modo lote ou o merge */
+typedef struct {
+    const char *mode;             /* "single", "incremental", "resume", "batch", "merge" */
+    const char *input;            /* NULL nos modos lote/merge */
+    const char *output;           /* saída (ou base das partes); NULL no modo lote */
+    int         exit_code;
+    int         files;            /* entradas processadas */
+    StageTime   total;            /* cpu: do processo inteiro */
+    StageTime   open;             /* header e campos (.dbc: início da descompressão) */
+    StageTime   prepare;          /* --where, projeção, amostra, schema e abertura do writer */
+    StageTime   close;            /* footer do Parquet (--resume: montagem da saída final) */
+    ConvStats   conv;
+    long long   bytes_read;       /* tamanho das entradas no disco */
+    long long   bytes_written;    /* tamanho das saídas gravadas */
+    long long   peak_rss;
+} RunStats;
+
+/* Soma em `dst` as etapas, contadores, bytes e arquivos de `src` (modo lote) */
+void stats_add_run(RunStats *dst, const RunStats *src);
+
+/* Tamanho do arquivo em bytes (0 se não existe) */
+long long stats_file_size(const char *path);
+
+/* Grava `s` como um documento JSON em `path` ("-" = stdout). 0 ok, -1 erro. */
+int stats_write_json(const RunStats *s, const char *path);
+
+#endif
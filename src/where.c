@@ -0,0 +1,377 @@
+#include "where.h"
+#include "encoding.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <glib.h>
+
+typedef enum { OP_EQ, OP_NE, OP_LT, OP_LE, OP_GT, OP_GE, OP_IN, OP_BETWEEN, OP_PREFIX } WhereOp;
+typedef enum { CMP_TEXT, CMP_NUM, CMP_DATE, CMP_BOOL } WhereCmp;
+
+typedef struct {
+    char   *bytes;   /* TEXT/DATE: bytes na codepage do arquivo (g_free) */
+    size_t  len;
+    double  num;     /* NUM */
+    int     truth;   /* BOOL */
+} WhereValue;
+
+typedef struct {
+    ColumnSpec  col;     /* offset < 0: coluna ausente no arquivo → sempre falso */
+    WhereOp     op;
+    WhereCmp    cmp;
+    WhereValue *vals;    /* 1 valor; IN: nvals; BETWEEN: [min, max] */
+    int         nvals;
+} WherePred;
+
+struct WhereFilter {
+    WherePred *preds;
+    int        npreds;
+};
+
+static int where_fail(char *msg, size_t msglen, const char *fmt, ...) G_GNUC_PRINTF(3, 4);
+static int where_fail(char *msg, size_t msglen, const char *fmt, ...) {
+    va_list ap;
+    va_start(ap, fmt);
+    vsnprintf(msg, msglen, fmt, ap);
+    va_end(ap);
+    return -1;
+}
+
+/* --- avaliação (por registro, sobre os bytes crus) --- */
+
+static int compare_bytes(const char *a, size_t alen, const char *b, size_t blen) {
+    int c = memcmp(a, b, alen < blen ? alen : blen);
+    if (c != 0) return c;
+    return alen < blen ? -1 : alen > blen;
+}
+
+static int compare_value(const WherePred *pr, const WhereValue *v, const char *p, size_t len, double x) {
+    if (pr->cmp == CMP_NUM) return x < v->num ? -1 : x > v->num;
+    return compare_bytes(p, len, v->bytes, v->len);
+}
+
+static int pred_match(const WherePred *pr, const unsigned char *rec) {
+    if (pr->col.offset < 0) return 0;
+    size_t len;
+    const char *p = dbf_field(rec, &pr->col, &len);
+    if (dbf_field_is_null(&pr->col, p, len)) return 0;
+
+    double x = 0;
+    switch (pr->cmp) {
+        case CMP_NUM:
+            if (dbf_parse_f64(p, len, &x) != 0) return 0;
+            break;
+        case CMP_DATE:
+            if (len != 8) return 0;
+            break;
+        case CMP_BOOL: {
+            char c = p[0];
+            int t = c == 'T' || c == 't' || c == 'Y' || c == 'y' || c == '1';
+            return pr->op == OP_EQ ? t == pr->vals[0].truth : t != pr->vals[0].truth;
+        }
+        default:
+            break;
+    }
+
+    switch (pr->op) {
+        case OP_EQ: return compare_value(pr, &pr->vals[0], p, len, x) == 0;
+        case OP_NE: return compare_value(pr, &pr->vals[0], p, len, x) != 0;
+        case OP_LT: return compare_value(pr, &pr->vals[0], p, len, x) < 0;
+        case OP_LE: return compare_value(pr, &pr->vals[0], p, len, x) <= 0;
+        case OP_GT: return compare_value(pr, &pr->vals[0], p, len, x) > 0;
+        case OP_GE: return compare_value(pr, &pr->vals[0], p, len, x) >= 0;
+        case OP_IN:
+            for (int i = 0; i < pr->nvals; i++)
+                if (compare_value(pr, &pr->vals[i], p, len, x) == 0) return 1;
+            return 0;
+        case OP_BETWEEN:
+            return compare_value(pr, &pr->vals[0], p, len, x) >= 0 &&
+                   compare_value(pr, &pr->vals[1], p, len, x) <= 0;
+        case OP_PREFIX:
+            return len >= pr->vals[0].len && memcmp(p, pr->vals[0].bytes, pr->vals[0].len) == 0;
+    }
+    return 0;
+}
+
+int where_select(const WhereFilter *w, const DbfCtx *ctx, int row,
+                 const int *sel, int nsel, int *out) {
+    const unsigned char *base = dbf_record(ctx, row);
+    const size_t rl = (size_t)ctx->record_len;
+    int m = 0;
+    for (int k = 0; k < nsel; k++) {
+        int r = sel ? sel[k] : k;
+        const unsigned char *rec = base + (size_t)r * rl;
+        int ok = 1;
+        for (int i = 0; ok && i < w->npreds; i++) ok = pred_match(&w->preds[i], rec);
+        if (ok) out[m++] = r;
+    }
+    return m;
+}
+
+/* --- compilação --- */
+
+typedef struct {
+    const char *p;
+} Lexer;
+
+static void skip_ws(Lexer *lx) {
+    while (*lx->p == ' ' || *lx->p == '\t') lx->p++;
+}
+
+static int is_ident_char(char c) {
+    return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+/* Palavra-chave (sem diferença de maiúsculas) seguida de não-identificador */
+static int match_kw(Lexer *lx, const char *kw) {
+    skip_ws(lx);
+    size_t n = strlen(kw);
+    if (g_ascii_strncasecmp(lx->p, kw, n) != 0 || is_ident_char(lx->p[n])) return 0;
+    lx->p += n;
+    return 1;
+}
+
+static int match_char(Lexer *lx, char c) {
+    skip_ws(lx);
+    if (*lx->p != c) return 0;
+    lx->p++;
+    return 1;
+}
+
+static char* read_ident(Lexer *lx) {
+    skip_ws(lx);
+    const char *s = lx->p;
+    while (is_ident_char(*lx->p)) lx->p++;
+    return lx->p > s ? g_strndup(s, (gsize)(lx->p - s)) : NULL;
+}
+
+/* Valor entre aspas simples ('' = aspa) ou até espaço, ',' ou ')' */
+static char* read_value(Lexer *lx) {
+    skip_ws(lx);
+    if (*lx->p == '\'') {
+        GString *v = g_string_new(NULL);
+        for (lx->p++; ; lx->p++) {
+            if (*lx->p == '\0') { g_string_free(v, TRUE); return NULL; }
+            if (*lx->p == '\'') {
+                if (lx->p[1] != '\'') { lx->p++; break; }
+                lx->p++;
+            }
+            g_string_append_c(v, *lx->p);
+        }
+        return g_string_free(v, FALSE);
+    }
+    const char *s = lx->p;
+    while (*lx->p && *lx->p != ' ' && *lx->p != '\t' && *lx->p != ',' && *lx->p != ')') lx->p++;
+    return lx->p > s ? g_strndup(s, (gsize)(lx->p - s)) : NULL;
+}
+
+static int read_op(Lexer *lx, WhereOp *op) {
+    static const struct { const char *s; WhereOp op; } ops[] = {
+        { "<=", OP_LE }, { ">=", OP_GE }, { "<>", OP_NE }, { "!=", OP_NE }, { "==", OP_EQ },
+        { "=",  OP_EQ }, { "<",  OP_LT }, { ">",  OP_GT },
+    };
+    skip_ws(lx);
+    for (size_t i = 0; i < sizeof(ops) / sizeof(ops[0]); i++) {
+        size_t n = strlen(ops[i].s);
+        if (strncmp(lx->p, ops[i].s, n) == 0) {
+            lx->p += n;
+            *op = ops[i].op;
+            return 0;
+        }
+    }
+    if (match_kw(lx, "IN"))      { *op = OP_IN;      return 0; }
+    if (match_kw(lx, "BETWEEN")) { *op = OP_BETWEEN; return 0; }
+    if (match_kw(lx, "LIKE"))    { *op = OP_PREFIX;  return 0; }
+    return -1;
+}
+
+/* Literal (UTF-8) → valor comparável com o campo */
+static int convert_value(const WherePred *pr, const EncCtx *enc, char *lit, WhereValue *v,
+                         char *msg, size_t msglen) {
+    const char *name = pr->col.name;
+    switch (pr->cmp) {
+        case CMP_NUM: {
+            char *end = NULL;
+            v->num = g_ascii_strtod(lit, &end);
+            if (end == lit || *end)
+                return where_fail(msg, msglen, "--where: valor numérico inválido para %s: %s", name, lit);
+            return 0;
+        }
+        case CMP_DATE: {
+            /* AAAAMMDD ou AAAA-MM-DD */
+            char d[9];
+            size_t n = strlen(lit);
+            if (n == 10 && lit[4] == '-' && lit[7] == '-') {
+                memcpy(d, lit, 4); memcpy(d + 4, lit + 5, 2); memcpy(d + 6, lit + 8, 2);
+            } else if (n == 8) {
+                memcpy(d, lit, 8);
+            } else {
+                return where_fail(msg, msglen, "--where: data inválida para %s (AAAAMMDD): %s", name, lit);
+            }
+            d[8] = '\0';
+            for (int i = 0; i < 8; i++)
+                if (d[i] < '0' || d[i] > '9')
+                    return where_fail(msg, msglen, "--where: data inválida para %s (AAAAMMDD): %s", name, lit);
+            v->bytes = g_strndup(d, 8);
+            v->len = 8;
+            return 0;
+        }
+        case CMP_BOOL: {
+            char c = lit[0];
+            if (c && strchr("TtYySs1", c))   v->truth = 1;
+            else if (c && strchr("FfNn0", c)) v->truth = 0;
+            else return where_fail(msg, msglen, "--where: valor lógico inválido para %s: %s", name, lit);
+            return 0;
+        }
+        default: {
+            /* os campos são comparados sem os espaços das pontas */
+            char *t = g_strstrip(lit);
+            size_t n = strlen(t);
+            v->bytes = (char*)g_malloc(n + 1);
+            if (pr->col.offset < 0) {
+                memcpy(v->bytes, t, n);
+                v->len = n;
+            } else if (enc_from_utf8(enc, t, n, v->bytes, &v->len) != 0) {
+                return where_fail(msg, msglen, "--where: valor sem representação na codepage %s: %s",
+                                  enc->cp, t);
+            }
+            return 0;
+        }
+    }
+}
+
+static int add_value(WherePred *pr, const EncCtx *enc, char *lit, char *msg, size_t msglen) {
+    pr->vals = g_renew(WhereValue, pr->vals, pr->nvals + 1);
+    WhereValue *v = &pr->vals[pr->nvals++];
+    memset(v, 0, sizeof(*v));
+    int rc = convert_value(pr, enc, lit, v, msg, msglen);
+    g_free(lit);
+    return rc;
+}
+
+static int parse_pred(Lexer *lx, WherePred *pr, const ColumnSpec *cols, int ncols, int missing_ok,
+                      const EncCtx *enc, char *msg, size_t msglen) {
+    char *name = read_ident(lx);
+    if (!name) return where_fail(msg, msglen, "--where: nome de coluna esperado em: %s", lx->p);
+
+    int found = -1;
+    for (int i = 0; i < ncols && found < 0; i++)
+        if (g_ascii_strcasecmp(cols[i].name, name) == 0) found = i;
+    if (found < 0 && !missing_ok) {
+        where_fail(msg, msglen, "--where: coluna inexistente: %s", name);
+        g_free(name);
+        return -1;
+    }
+    if (found >= 0) {
+        pr->col = cols[found];
+    } else {
+        g_strlcpy(pr->col.name, name, sizeof(pr->col.name));
+        pr->col.offset = -1;
+    }
+    g_free(name);
+
+    switch (pr->col.offset < 0 ? 'C' : pr->col.type) {
+        case 'N': case 'F': pr->cmp = CMP_NUM;  break;
+        case 'D':           pr->cmp = CMP_DATE; break;
+        case 'L':           pr->cmp = CMP_BOOL; break;
+        case 'M':
+            return where_fail(msg, msglen, "--where: campo memo não pode ser filtrado: %s", pr->col.name);
+        default:            pr->cmp = CMP_TEXT; break;
+    }
+
+    if (read_op(lx, &pr->op) != 0)
+        return where_fail(msg, msglen, "--where: operador esperado após %s", pr->col.name);
+    if (pr->cmp == CMP_BOOL && pr->op != OP_EQ && pr->op != OP_NE)
+        return where_fail(msg, msglen, "--where: campo lógico %s só aceita = e !=", pr->col.name);
+
+    char *lit;
+    switch (pr->op) {
+        case OP_IN:
+            if (!match_char(lx, '('))
+                return where_fail(msg, msglen, "--where: '(' esperado após %s IN", pr->col.name);
+            do {
+                if (!(lit = read_value(lx)))
+                    return where_fail(msg, msglen, "--where: valor esperado na lista de %s", pr->col.name);
+                if (add_value(pr, enc, lit, msg, msglen) != 0) return -1;
+            } while (match_char(lx, ','));
+            if (!match_char(lx, ')'))
+                return where_fail(msg, msglen, "--where: ')' esperado na lista de %s", pr->col.name);
+            return 0;
+
+        case OP_BETWEEN:
+            if (!(lit = read_value(lx)) || add_value(pr, enc, lit, msg, msglen) != 0 ||
+                !match_kw(lx, "AND") ||
+                !(lit = read_value(lx)) || add_value(pr, enc, lit, msg, msglen) != 0) {
+                if (!msg[0]) where_fail(msg, msglen, "--where: use %s BETWEEN v1 AND v2", pr->col.name);
+                return -1;
+            }
+            return 0;
+
+        case OP_PREFIX: {
+            if (pr->cmp != CMP_TEXT)
+                return where_fail(msg, msglen, "--where: LIKE só vale para campos texto: %s", pr->col.name);
+            if (!(lit = read_value(lx)))
+                return where_fail(msg, msglen, "--where: valor esperado após %s LIKE", pr->col.name);
+            size_t n = strlen(lit);
+            char *pct = strchr(lit, '%');
+            if (!pct) {
+                pr->op = OP_EQ;
+            } else if (pct != lit + n - 1) {
+                g_free(lit);
+                return where_fail(msg, msglen, "--where: LIKE só aceita prefixo ('ABC%%'): %s", pr->col.name);
+            } else {
+                *pct = '\0';
+            }
+            return add_value(pr, enc, lit, msg, msglen);
+        }
+
+        default:
+            if (!(lit = read_value(lx)))
+                return where_fail(msg, msglen, "--where: valor esperado após %s", pr->col.name);
+            return add_value(pr, enc, lit, msg, msglen);
+    }
+}
+
+WhereFilter* where_compile(char **exprs, int nexprs, const ColumnSpec *cols, int ncols,
+                           const char *from_cp, int missing_ok, char *msg, size_t msglen) {
+    msg[0] = '\0';
+    EncCtx enc;
+    if (enc_open(&enc, from_cp) != 0) {
+        where_fail(msg, msglen, "Sem memória.");
+        return NULL;
+    }
+
+    WhereFilter *w = g_new0(WhereFilter, 1);
+    int rc = 0;
+    for (int e = 0; rc == 0 && e < nexprs; e++) {
+        Lexer lx = { exprs[e] };
+        do {
+            w->preds = g_renew(WherePred, w->preds, w->npreds + 1);
+            WherePred *pr = &w->preds[w->npreds++];
+            memset(pr, 0, sizeof(*pr));
+            rc = parse_pred(&lx, pr, cols, ncols, missing_ok, &enc, msg, msglen);
+        } while (rc == 0 && match_kw(&lx, "AND"));
+        skip_ws(&lx);
+        if (rc == 0 && *lx.p)
+            rc = where_fail(msg, msglen, "--where: AND ou fim da expressão esperado em: %s", lx.p);
+    }
+    enc_close(&enc);
+
+    if (rc != 0) {
+        where_free(w);
+        return NULL;
+    }
+    return w;
+}
+
+void where_free(WhereFilter *w) {
+    if (!w) return;
+    for (int i = 0; i < w->npreds; i++) {
+        for (int j = 0; j < w->preds[i].nvals; j++) g_free(w->preds[i].vals[j].bytes);
+        g_free(w->preds[i].vals);
+    }
+    g_free(w->preds);
+    g_free(w);
+}
@@ -0,0 +1,34 @@
+#ifndef WHERE_H
+#define WHERE_H
+
+#include <stddef.h>
+#include "dbf_reader.h"
+
+/* Filtro de linhas (--where) avaliado nos bytes crus dos campos, antes de
+   qualquer decodificação: só as linhas que passam chegam aos decodificadores.
+
+   Predicados:  COL = v | COL != v | COL <> v | COL < v | COL <= v | COL > v | COL >= v
+                COL IN (v1, v2, ...) | COL BETWEEN v1 AND v2 | COL LIKE 'pref%'
+   unidos por AND (numa expressão ou em várias --where). Valores entre aspas
+   simples ('' = aspa) ou sem aspas até espaço, ',' ou ')'.
+   A comparação segue o tipo nativo do campo: C por bytes (o valor é convertido
+   para a codepage do arquivo), N/F numérica, D por AAAAMMDD (aceita também
+   AAAA-MM-DD), L verdadeiro/falso (só = e !=). Campo nulo não passa. */
+typedef struct WhereFilter WhereFilter;
+
+/* Compila as `nexprs` expressões contra as colunas do arquivo (nomes sem
+   diferença de maiúsculas; usa offset/largura/tipo de `cols`). Com missing_ok,
+   coluna ausente não é erro e o predicado é sempre falso (merge: arquivo sem a
+   coluna). Retorna NULL em erro, com a mensagem em `msg`. */
+WhereFilter* where_compile(char **exprs, int nexprs, const ColumnSpec *cols, int ncols,
+                           const char *from_cp, int missing_ok, char *msg, size_t msglen);
+
+/* Filtra as linhas do lote que começa em `row`: as de `sel` (nsel índices
+   relativos) ou, se sel == NULL, 0..nsel-1. Grava as que passam em `out`, em
+   ordem (pode ser o próprio `sel`), e retorna quantas são. */
+int where_select(const WhereFilter *w, const DbfCtx *ctx, int row,
+                 const int *sel, int nsel, int *out);
+
+void where_free(WhereFilter *w);
+
+#endif